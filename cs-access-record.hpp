@@ -0,0 +1,47 @@
+#ifndef NDNSIM_SCRATCH_CS_ACCESS_RECORD_HPP
+#define NDNSIM_SCRATCH_CS_ACCESS_RECORD_HPP
+
+#include <cstdint>
+
+/**
+ * \brief Binary CS access stream written by custom-cs-access-recorder.hpp
+ *
+ * Shared with the offline replay tool (cs-replay.cc), so it has no ns-3 dependency.
+ * The file is a CsAccessFileHeader followed by 16-byte records in simulation order, all
+ * nodes interleaved, host byte order.
+*/
+
+namespace ns3 {
+namespace ndn {
+namespace csrecord {
+
+constexpr uint32_t MAGIC = 0x52415343; // "CSAR"
+constexpr uint32_t VERSION = 1;
+
+enum Op : uint8_t {
+  LOOKUP_HIT = 1,  // interest found data in the CS
+  LOOKUP_MISS = 2, // interest did not
+  INSERT = 3,      // data arrived at the node and was offered to the CS
+};
+
+struct CsAccessFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t recordSize;
+  uint32_t reserved;
+};
+
+struct CsAccessRecord {
+  uint64_t nameHash; // std::hash<Name> of the interest / data name
+  uint32_t node;
+  uint8_t op;
+  uint8_t reserved[3];
+};
+
+static_assert(sizeof(CsAccessRecord) == 16, "records are 16 bytes on disk");
+
+} // namespace csrecord
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CS_ACCESS_RECORD_HPP
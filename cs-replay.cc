@@ -0,0 +1,349 @@
+/**
+ * Offline cache replay of a stream recorded by custom-cs-access-recorder.hpp
+ *
+ *     cs-replay <file> [--node=N] [--sizes=10,100,1000] [--policies=opt,lru,fifo]
+ *
+ * For every node (or only N) the lookup/insert stream is replayed against each policy
+ * and cache size, and the lookup hit ratio is printed:
+ *
+ *     Node Policy Size Lookups Hits HitRatio
+ *
+ * Every record is a reference that brings the object into the cache; only lookups are
+ * counted as requests. "recorded" is the hit ratio the simulation itself saw.
+ *
+ * - lru: one pass for all sizes, stack distances counted with a Fenwick tree
+ *   (O(n log n) for the whole size list)
+ * - opt: Belady with bypass, evicting the object referenced furthest in the future
+ *   (O(n log size) per size)
+ * - fifo, priority_fifo: insertion order; without freshness information nfd's
+ *   priority_fifo reduces to fifo
+ *
+ * More policies are added with PolicyRegistry().
+ */
+
+#include "cs-access-record.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace ns3::ndn::csrecord;
+
+namespace {
+
+/**
+ * \brief Access stream of one node with names mapped to dense ids
+ */
+struct Trace {
+  std::vector<uint32_t> ids;
+  std::vector<uint8_t> ops;
+  std::vector<uint32_t> nextUse; // index of the next reference to the same id, size() if none
+  uint32_t distinct = 0;
+  uint64_t lookups = 0;
+  uint64_t recordedHits = 0;
+
+  void Finish() {
+    nextUse.assign(ids.size(), static_cast<uint32_t>(ids.size()));
+    std::vector<uint32_t> seen(distinct, static_cast<uint32_t>(ids.size()));
+    for (std::size_t i = ids.size(); i-- > 0;) {
+      nextUse[i] = seen[ids[i]];
+      seen[ids[i]] = static_cast<uint32_t>(i);
+    }
+  }
+
+  bool IsLookup(std::size_t i) const {
+    return ops[i] == LOOKUP_HIT || ops[i] == LOOKUP_MISS;
+  }
+};
+
+/**
+ * \brief Cache simulated reference by reference
+ */
+class Policy {
+public:
+  virtual ~Policy() = default;
+
+  /**
+   * \brief Reference trace.ids[i]
+   * \returns true if it was cached
+   */
+  virtual bool Reference(const Trace& trace, std::size_t i) = 0;
+};
+
+class FifoPolicy : public Policy {
+public:
+  explicit FifoPolicy(std::size_t capacity)
+    : m_capacity(capacity) {
+  }
+
+  bool Reference(const Trace& trace, std::size_t i) override {
+    uint32_t id = trace.ids[i];
+    if (m_cached.count(id)) {
+      return true;
+    }
+    if (m_capacity == 0) {
+      return false;
+    }
+    if (m_order.size() == m_capacity) {
+      m_cached.erase(m_order.front());
+      m_order.pop_front();
+    }
+    m_order.push_back(id);
+    m_cached.insert(id);
+    return false;
+  }
+
+private:
+  std::size_t m_capacity;
+  std::deque<uint32_t> m_order;
+  std::unordered_set<uint32_t> m_cached;
+};
+
+class OptPolicy : public Policy {
+public:
+  explicit OptPolicy(std::size_t capacity)
+    : m_capacity(capacity) {
+  }
+
+  bool Reference(const Trace& trace, std::size_t i) override {
+    uint32_t id = trace.ids[i];
+    uint32_t next = trace.nextUse[i];
+
+    auto cached = m_nextOf.find(id);
+    if (cached != m_nextOf.end()) {
+      m_byNext.erase(std::make_pair(cached->second, id));
+      cached->second = next;
+      m_byNext.insert(std::make_pair(next, id));
+      return true;
+    }
+
+    if (m_capacity == 0) {
+      return false;
+    }
+    if (m_nextOf.size() == m_capacity) {
+      auto furthest = std::prev(m_byNext.end());
+      if (furthest->first <= next) {
+        return false; // bypass: the new object is needed later than everything cached
+      }
+      m_nextOf.erase(furthest->second);
+      m_byNext.erase(furthest);
+    }
+    m_nextOf[id] = next;
+    m_byNext.insert(std::make_pair(next, id));
+    return false;
+  }
+
+private:
+  std::size_t m_capacity;
+  std::unordered_map<uint32_t, uint32_t> m_nextOf;
+  std::set<std::pair<uint32_t, uint32_t>> m_byNext;
+};
+
+std::map<std::string, std::function<std::unique_ptr<Policy>(std::size_t)>>&
+PolicyRegistry()
+{
+  static std::map<std::string, std::function<std::unique_ptr<Policy>(std::size_t)>> registry = {
+    { "opt", [](std::size_t capacity) { return std::unique_ptr<Policy>(new OptPolicy(capacity)); } },
+    { "fifo", [](std::size_t capacity) { return std::unique_ptr<Policy>(new FifoPolicy(capacity)); } },
+    { "priority_fifo", [](std::size_t capacity) { return std::unique_ptr<Policy>(new FifoPolicy(capacity)); } },
+  };
+  return registry;
+}
+
+/**
+ * \brief LRU hits of the lookups for every size at once (Mattson stack distances)
+ *
+ * mark[p] is 1 while position p holds the latest reference of its object, so the
+ * number of distinct objects referenced since the last reference of x is a range sum.
+ */
+std::vector<uint64_t>
+LruHits(const Trace& trace, const std::vector<std::size_t>& sizes)
+{
+  std::size_t n = trace.ids.size();
+  std::vector<int32_t> tree(n + 1, 0);
+  auto add = [&](std::size_t pos, int32_t delta) {
+    for (std::size_t i = pos + 1; i <= n; i += i & (~i + 1)) {
+      tree[i] += delta;
+    }
+  };
+  auto prefix = [&](std::size_t pos) { // sum of mark[0..pos)
+    int64_t sum = 0;
+    for (std::size_t i = pos; i > 0; i -= i & (~i + 1)) {
+      sum += tree[i];
+    }
+    return sum;
+  };
+
+  std::size_t maxSize = sizes.empty() ? 0 : *std::max_element(sizes.begin(), sizes.end());
+  std::vector<uint64_t> byDistance(maxSize + 1, 0); // lookups whose stack distance is d (capped)
+  std::vector<uint32_t> last(trace.distinct, UINT32_MAX);
+
+  for (std::size_t t = 0; t < n; t++) {
+    uint32_t id = trace.ids[t];
+    if (last[id] != UINT32_MAX) {
+      std::size_t distance = prefix(t) - prefix(last[id] + 1); // distinct objects in between
+      if (trace.IsLookup(t)) {
+        byDistance[std::min(distance, maxSize)]++;
+      }
+      add(last[id], -1);
+    }
+    add(t, 1);
+    last[id] = static_cast<uint32_t>(t);
+  }
+
+  // a reference with distance d hits in every cache holding more than d objects
+  std::vector<uint64_t> hits;
+  for (std::size_t size : sizes) {
+    uint64_t sum = 0;
+    for (std::size_t d = 0; d < size && d < maxSize; d++) {
+      sum += byDistance[d];
+    }
+    hits.push_back(sum);
+  }
+  return hits;
+}
+
+uint64_t
+PolicyHits(const std::string& name, const Trace& trace, std::size_t size)
+{
+  std::unique_ptr<Policy> policy = PolicyRegistry().at(name)(size);
+  uint64_t hits = 0;
+  for (std::size_t i = 0; i < trace.ids.size(); i++) {
+    if (policy->Reference(trace, i) && trace.IsLookup(i)) {
+      hits++;
+    }
+  }
+  return hits;
+}
+
+std::vector<std::string>
+Split(const std::string& list)
+{
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+void
+PrintRow(uint32_t node, const std::string& policy, std::size_t size, uint64_t lookups, uint64_t hits)
+{
+  std::printf("%u\t%s\t%zu\t%llu\t%llu\t%.4f\n", node, policy.c_str(), size, static_cast<unsigned long long>(lookups),
+              static_cast<unsigned long long>(hits), lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups);
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::string file;
+  long onlyNode = -1;
+  std::vector<std::size_t> sizes = { 10, 50, 100, 500, 1000, 5000 };
+  std::vector<std::string> policies = { "opt", "lru", "fifo" };
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 7, "--node=") == 0) {
+      onlyNode = std::atol(arg.c_str() + 7);
+    }
+    else if (arg.compare(0, 8, "--sizes=") == 0) {
+      sizes.clear();
+      for (const std::string& size : Split(arg.substr(8))) {
+        sizes.push_back(std::strtoul(size.c_str(), nullptr, 10));
+      }
+    }
+    else if (arg.compare(0, 11, "--policies=") == 0) {
+      policies = Split(arg.substr(11));
+    }
+    else if (file.empty() && arg.compare(0, 2, "--") != 0) {
+      file = arg;
+    }
+    else {
+      file.clear();
+      break;
+    }
+  }
+
+  for (const std::string& policy : policies) {
+    if (policy != "lru" && PolicyRegistry().count(policy) == 0) {
+      std::fprintf(stderr, "Unknown policy %s\n", policy.c_str());
+      return 1;
+    }
+  }
+  if (file.empty() || sizes.empty()) {
+    std::fprintf(stderr, "usage: %s <file> [--node=N] [--sizes=10,100,...] [--policies=opt,lru,fifo,...]\n", argv[0]);
+    return 1;
+  }
+
+  std::ifstream is(file, std::ios_base::binary);
+  CsAccessFileHeader header;
+  if (!is.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != MAGIC
+      || header.version != VERSION || header.recordSize != sizeof(CsAccessRecord)) {
+    std::fprintf(stderr, "%s is not a CS access recording\n", file.c_str());
+    return 1;
+  }
+
+  std::map<uint32_t, Trace> traces;
+  std::map<uint32_t, std::unordered_map<uint64_t, uint32_t>> idOf;
+  std::vector<CsAccessRecord> buffer(65536);
+  while (is) {
+    is.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(CsAccessRecord));
+    std::size_t n = is.gcount() / sizeof(CsAccessRecord);
+    for (std::size_t i = 0; i < n; i++) {
+      const CsAccessRecord& record = buffer[i];
+      if (onlyNode >= 0 && record.node != static_cast<uint32_t>(onlyNode)) {
+        continue;
+      }
+      Trace& trace = traces[record.node];
+      std::unordered_map<uint64_t, uint32_t>& ids = idOf[record.node];
+      auto id = ids.emplace(record.nameHash, trace.distinct);
+      if (id.second) {
+        trace.distinct++;
+      }
+      trace.ids.push_back(id.first->second);
+      trace.ops.push_back(record.op);
+      trace.lookups += record.op == LOOKUP_HIT || record.op == LOOKUP_MISS;
+      trace.recordedHits += record.op == LOOKUP_HIT;
+    }
+  }
+  idOf.clear();
+
+  std::printf("Node\tPolicy\tSize\tLookups\tHits\tHitRatio\n");
+  for (std::pair<const uint32_t, Trace>& entry : traces) {
+    Trace& trace = entry.second;
+    trace.Finish();
+    PrintRow(entry.first, "recorded", 0, trace.lookups, trace.recordedHits);
+
+    for (const std::string& policy : policies) {
+      if (policy == "lru") {
+        std::vector<uint64_t> hits = LruHits(trace, sizes);
+        for (std::size_t s = 0; s < sizes.size(); s++) {
+          PrintRow(entry.first, policy, sizes[s], trace.lookups, hits[s]);
+        }
+        continue;
+      }
+      for (std::size_t size : sizes) {
+        PrintRow(entry.first, policy, size, trace.lookups, PolicyHits(policy, trace, size));
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,234 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_APP_DELAY_AGGREGATE_TRACER_HPP
+#define NDNSIM_SCRATCH_CUSTOM_APP_DELAY_AGGREGATE_TRACER_HPP
+
+#include "ns3/application.h"
+#include "ns3/names.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include "custom-trace-filter.hpp"
+#include "streaming-histogram.hpp"
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief Aggregating replacement for AppDelayTracer
+ *
+ * Instead of one line per satisfied interest, every consumer keeps two fixed-size
+ * LogHistogram (microseconds) per period:
+ *
+ * - FullDelay: from the first interest to the data (FirstInterestDataDelay)
+ * - LastDelay: from the last retransmission to the data (LastRetransmittedInterestDataDelay)
+ *
+ * and once per period prints for each app that received data:
+ *
+ *     Time Node AppId Type Count P50 P90 P99 P999 Retx
+ *
+ * (quantiles in seconds; Retx is the number of retransmissions of the FullDelay samples).
+ *
+ * With a TraceFilter, apps whose Prefix is not under the filter prefix are never
+ * connected; the sampling rate is applied per (app, sequence number).
+*/
+class AppDelayAggregateTracer : public SimpleRefCount<AppDelayAggregateTracer> {
+public:
+  static void InstallAll(const std::string& file, Time averagingPeriod = Seconds(1.0)) {
+    NodeContainer nodes;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      nodes.Add(*node);
+    }
+    Install(nodes, file, averagingPeriod);
+  }
+
+  static void Install(const NodeContainer& nodes, const std::string& file, Time averagingPeriod = Seconds(1.0),
+                      const TraceFilter& filter = TraceFilter()) {
+    std::list<Ptr<AppDelayAggregateTracer>> tracers;
+    std::shared_ptr<std::ostream> outputStream = OpenStream(file);
+    if (outputStream == nullptr) {
+      return;
+    }
+
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+      tracers.push_back(Install(*node, outputStream, averagingPeriod, filter));
+    }
+
+    if (tracers.size() > 0) {
+      tracers.front()->PrintHeader(*outputStream);
+      *outputStream << "\n";
+    }
+
+    Registry().push_back(std::make_tuple(outputStream, tracers));
+  }
+
+  static Ptr<AppDelayAggregateTracer> Install(Ptr<Node> node, std::shared_ptr<std::ostream> outputStream,
+                                              Time averagingPeriod = Seconds(1.0),
+                                              const TraceFilter& filter = TraceFilter()) {
+    Ptr<AppDelayAggregateTracer> trace = Create<AppDelayAggregateTracer>(outputStream, node, filter);
+    trace->SetAveragingPeriod(averagingPeriod);
+    return trace;
+  }
+
+  /**
+   * \brief Explicit request to remove all statically created tracers
+  */
+  static void Destroy() {
+    Registry().clear();
+  }
+
+  AppDelayAggregateTracer(std::shared_ptr<std::ostream> os, Ptr<Node> node, const TraceFilter& filter = TraceFilter())
+    : m_nodePtr(node)
+    , m_os(os)
+    , m_filter(filter) {
+    m_node = std::to_string(m_nodePtr->GetId());
+    std::string name = Names::FindName(node);
+    if (!name.empty()) {
+      m_node = name;
+    }
+    Connect();
+  }
+
+  ~AppDelayAggregateTracer() {
+    Simulator::Cancel(m_printEvent);
+  }
+
+  void PrintHeader(std::ostream& os) const {
+    os << "Time" << "\t" << "Node" << "\t" << "AppId" << "\t" << "Type" << "\t" << "Count" << "\t"
+       << "P50" << "\t" << "P90" << "\t" << "P99" << "\t" << "P999" << "\t" << "Retx";
+  }
+
+  void Print(std::ostream& os) const {
+    double time = Simulator::Now().ToDouble(Time::S);
+
+    for (const std::pair<const uint32_t, AppStats>& app : m_apps) {
+      const AppStats& stats = app.second;
+      if (stats.full.GetCount() == 0 && stats.last.GetCount() == 0) {
+        continue;
+      }
+
+#define PRINTER(printName, histogram, retx) \
+  os << time << "\t" << m_node << "\t" << app.first << "\t" << printName << "\t" << histogram.GetCount() \
+     << "\t" << histogram.Quantile(0.5) / 1e6 << "\t" << histogram.Quantile(0.9) / 1e6 \
+     << "\t" << histogram.Quantile(0.99) / 1e6 << "\t" << histogram.Quantile(0.999) / 1e6 \
+     << "\t" << retx << "\n";
+
+      PRINTER("FullDelay", stats.full, stats.retx);
+      PRINTER("LastDelay", stats.last, 0);
+
+#undef PRINTER
+    }
+  }
+
+protected:
+  struct AppStats {
+    LogHistogram full;
+    LogHistogram last;
+    uint64_t retx = 0;
+  };
+
+  static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<AppDelayAggregateTracer>>>>& Registry() {
+    static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<AppDelayAggregateTracer>>>> tracers;
+    return tracers;
+  }
+
+  static std::shared_ptr<std::ostream> OpenStream(const std::string& file) {
+    if (file == "-") {
+      return std::shared_ptr<std::ostream>(&std::cout, std::bind([] {}));
+    }
+
+    std::shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!os->is_open()) {
+      std::cerr << "File " << file << " cannot be opened for writing. Tracing disabled\n";
+      return nullptr;
+    }
+    return os;
+  }
+
+  /**
+   * \brief Connect to the delay trace sources of every ndn::App installed on the node
+  */
+  void Connect() {
+    for (uint32_t i = 0; i < m_nodePtr->GetNApplications(); i++) {
+      Ptr<App> app = DynamicCast<App>(m_nodePtr->GetApplication(i));
+      if (app != 0 && m_filter.MatchesApp(app)) {
+        ConnectApp(app);
+      }
+    }
+  }
+
+  void ConnectApp(Ptr<App> app) {
+    app->TraceConnectWithoutContext("FirstInterestDataDelay",
+      MakeCallback(&AppDelayAggregateTracer::FirstInterestDataDelay, this));
+    app->TraceConnectWithoutContext("LastRetransmittedInterestDataDelay",
+      MakeCallback(&AppDelayAggregateTracer::LastRetransmittedInterestDataDelay, this));
+  }
+
+  void SetAveragingPeriod(const Time& period) {
+    m_period = period;
+    m_printEvent.Cancel();
+    m_printEvent = Simulator::Schedule(m_period, &AppDelayAggregateTracer::PeriodicPrinter, this);
+  }
+
+  void PeriodicPrinter() {
+    Print(*m_os);
+    Reset();
+    m_printEvent = Simulator::Schedule(m_period, &AppDelayAggregateTracer::PeriodicPrinter, this);
+  }
+
+  void Reset() {
+    for (std::pair<const uint32_t, AppStats>& app : m_apps) {
+      app.second.full.Reset();
+      app.second.last.Reset();
+      app.second.retx = 0;
+    }
+  }
+
+  void FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount, int32_t hopCount) {
+    if (!m_filter.IsSampled((uint64_t(app->GetId()) << 32) | seqno)) {
+      return;
+    }
+    AppStats& stats = m_apps[app->GetId()];
+    stats.full.Record(delay.GetMicroSeconds());
+    stats.retx += retxCount > 0 ? retxCount - 1 : 0;
+  }
+
+  void LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount) {
+    if (!m_filter.IsSampled((uint64_t(app->GetId()) << 32) | seqno)) {
+      return;
+    }
+    m_apps[app->GetId()].last.Record(delay.GetMicroSeconds());
+  }
+
+protected:
+  Ptr<Node> m_nodePtr;
+  std::string m_node;
+  std::shared_ptr<std::ostream> m_os;
+  TraceFilter m_filter;
+
+  Time m_period;
+  EventId m_printEvent;
+
+  std::map<uint32_t, AppStats> m_apps;
+};
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_APP_DELAY_AGGREGATE_TRACER_HPP
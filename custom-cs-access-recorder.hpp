@@ -0,0 +1,158 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_CS_ACCESS_RECORDER_HPP
+#define NDNSIM_SCRATCH_CUSTOM_CS_ACCESS_RECORDER_HPP
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "cs-access-record.hpp"
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief Records every CS lookup and insert as a 16-byte binary record
+ *
+ * Companion of custom::CsTracer: instead of periodic hit/miss counters it keeps the
+ * whole access stream (see cs-access-record.hpp), which cs-replay.cc replays offline
+ * against OPT, LRU, FIFO and other policies for many cache sizes.
+ *
+ * Lookups come from the forwarder afterCsHit/afterCsMiss signals, inserts from the
+ * L3Protocol InData trace source. Records of all nodes given to Install go to one file,
+ * through a buffer of RecordsPerFlush records.
+*/
+class CsAccessRecorder : public SimpleRefCount<CsAccessRecorder> {
+public:
+  static constexpr std::size_t RecordsPerFlush = 65536;
+
+  static void InstallAll(const std::string& file) {
+    NodeContainer nodes;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      nodes.Add(*node);
+    }
+    Install(nodes, file);
+  }
+
+  static void Install(const NodeContainer& nodes, const std::string& file) {
+    std::list<Ptr<CsAccessRecorder>> recorders;
+    std::shared_ptr<Writer> writer = Writer::Open(file);
+    if (writer == nullptr) {
+      return;
+    }
+
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+      if ((*node)->GetObject<L3Protocol>() == 0) {
+        continue;
+      }
+      recorders.push_back(Create<CsAccessRecorder>(writer, *node));
+    }
+
+    if (Registry().empty()) {
+      Simulator::ScheduleDestroy(&CsAccessRecorder::Destroy);
+    }
+    Registry().push_back(std::make_tuple(writer, recorders));
+  }
+
+  /**
+   * \brief Flush and close all recordings (also done when the simulator is destroyed)
+  */
+  static void Destroy() {
+    Registry().clear();
+  }
+
+protected:
+  /**
+   * \brief Buffered output shared by the recorders of one file
+  */
+  class Writer {
+  public:
+    static std::shared_ptr<Writer> Open(const std::string& file) {
+      std::shared_ptr<Writer> writer(new Writer());
+      writer->m_os.open(file.c_str(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+      if (!writer->m_os.is_open()) {
+        std::cerr << "File " << file << " cannot be opened for writing. Recording disabled\n";
+        return nullptr;
+      }
+
+      csrecord::CsAccessFileHeader header = { csrecord::MAGIC, csrecord::VERSION, sizeof(csrecord::CsAccessRecord), 0 };
+      writer->m_os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      writer->m_buffer.reserve(RecordsPerFlush);
+      return writer;
+    }
+
+    ~Writer() {
+      Flush();
+    }
+
+    void Add(uint64_t nameHash, uint32_t node, csrecord::Op op) {
+      m_buffer.push_back(csrecord::CsAccessRecord{ nameHash, node, op, { 0, 0, 0 } });
+      if (m_buffer.size() == RecordsPerFlush) {
+        Flush();
+      }
+    }
+
+    void Flush() {
+      m_os.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size() * sizeof(csrecord::CsAccessRecord));
+      m_os.flush();
+      m_buffer.clear();
+    }
+
+  private:
+    std::ofstream m_os;
+    std::vector<csrecord::CsAccessRecord> m_buffer;
+  };
+
+public:
+  CsAccessRecorder(std::shared_ptr<Writer> writer, Ptr<Node> node)
+    : m_writer(writer)
+    , m_nodeId(node->GetId()) {
+    Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+    std::shared_ptr<nfd::Forwarder> forwarder = l3->getForwarder();
+
+    m_hitConn = forwarder->afterCsHit.connect([this](const Interest& interest, const Data&) {
+      m_writer->Add(std::hash<Name>()(interest.getName()), m_nodeId, csrecord::LOOKUP_HIT);
+    });
+    m_missConn = forwarder->afterCsMiss.connect([this](const Interest& interest) {
+      m_writer->Add(std::hash<Name>()(interest.getName()), m_nodeId, csrecord::LOOKUP_MISS);
+    });
+    l3->TraceConnectWithoutContext("InData", MakeCallback(&CsAccessRecorder::InData, this));
+  }
+
+protected:
+  static std::list<std::tuple<std::shared_ptr<Writer>, std::list<Ptr<CsAccessRecorder>>>>& Registry() {
+    static std::list<std::tuple<std::shared_ptr<Writer>, std::list<Ptr<CsAccessRecorder>>>> recorders;
+    return recorders;
+  }
+
+  void InData(const Data& data, const Face& face) {
+    m_writer->Add(std::hash<Name>()(data.getName()), m_nodeId, csrecord::INSERT);
+  }
+
+protected:
+  std::shared_ptr<Writer> m_writer;
+  uint32_t m_nodeId;
+
+  ::ndn::util::signal::ScopedConnection m_hitConn;
+  ::ndn::util::signal::ScopedConnection m_missConn;
+};
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_CS_ACCESS_RECORDER_HPP
@@ -0,0 +1,207 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_FLOW_TRACER_HPP
+#define NDNSIM_SCRATCH_CUSTOM_FLOW_TRACER_HPP
+
+#include "ns3/names.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+
+#include "ndn-consumer-aimd.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief Per flow tracer of the window-based consumers (ConsumerAimd)
+ *
+ * Once per period prints for every ConsumerAimd installed on the node:
+ *
+ *     Time Node AppId Window MaxWindow InFlight GoodputKbps Interests Retx RetxRate Timeouts Nacks SrttMs RtoMs
+ *
+ * Window and InFlight are sampled at print time, MaxWindow is the largest window of the
+ * period (from the "Window" trace source); GoodputKbps counts the content of the first
+ * Data of every sequence number. Counts are per period; RetxRate is Retx / Interests.
+*/
+class FlowTracer : public SimpleRefCount<FlowTracer> {
+public:
+  static void InstallAll(const std::string& file, Time averagingPeriod = Seconds(1.0)) {
+    NodeContainer nodes;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      nodes.Add(*node);
+    }
+    Install(nodes, file, averagingPeriod);
+  }
+
+  static void Install(const NodeContainer& nodes, const std::string& file, Time averagingPeriod = Seconds(1.0)) {
+    std::list<Ptr<FlowTracer>> tracers;
+    std::shared_ptr<std::ostream> outputStream = OpenStream(file);
+    if (outputStream == nullptr) {
+      return;
+    }
+
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+      tracers.push_back(Install(*node, outputStream, averagingPeriod));
+    }
+
+    if (tracers.size() > 0) {
+      tracers.front()->PrintHeader(*outputStream);
+      *outputStream << "\n";
+    }
+
+    Registry().push_back(std::make_tuple(outputStream, tracers));
+  }
+
+  static Ptr<FlowTracer> Install(Ptr<Node> node, std::shared_ptr<std::ostream> outputStream,
+                                 Time averagingPeriod = Seconds(1.0)) {
+    Ptr<FlowTracer> trace = Create<FlowTracer>(outputStream, node);
+    trace->SetAveragingPeriod(averagingPeriod);
+    return trace;
+  }
+
+  /**
+   * \brief Explicit request to remove all statically created tracers
+  */
+  static void Destroy() {
+    Registry().clear();
+  }
+
+  FlowTracer(std::shared_ptr<std::ostream> os, Ptr<Node> node)
+    : m_nodePtr(node)
+    , m_os(os) {
+    m_node = std::to_string(m_nodePtr->GetId());
+    std::string name = Names::FindName(node);
+    if (!name.empty()) {
+      m_node = name;
+    }
+    Connect();
+  }
+
+  ~FlowTracer() {
+    Simulator::Cancel(m_printEvent);
+  }
+
+  void PrintHeader(std::ostream& os) const {
+    os << "Time" << "\t" << "Node" << "\t" << "AppId" << "\t" << "Window" << "\t" << "MaxWindow" << "\t"
+       << "InFlight" << "\t" << "GoodputKbps" << "\t" << "Interests" << "\t" << "Retx" << "\t" << "RetxRate"
+       << "\t" << "Timeouts" << "\t" << "Nacks" << "\t" << "SrttMs" << "\t" << "RtoMs";
+  }
+
+  void Print(std::ostream& os) const {
+    double time = Simulator::Now().ToDouble(Time::S);
+    double period = m_period.ToDouble(Time::S);
+
+    for (const std::pair<const uint32_t, Flow>& flow : m_flows) {
+      const ConsumerAimd::Counters& now = flow.second.app->GetCounters();
+      const ConsumerAimd::Counters& last = flow.second.last;
+
+#define DELTA(field) (now.field - last.field)
+
+      uint64_t interests = DELTA(interests);
+      os << time << "\t" << m_node << "\t" << flow.first << "\t" << flow.second.app->GetWindow() << "\t"
+         << flow.second.maxWindow << "\t" << flow.second.app->GetInFlight() << "\t"
+         << (period > 0 ? DELTA(bytes) * 8 / 1000.0 / period : 0) << "\t" << interests << "\t"
+         << DELTA(retransmissions) << "\t"
+         << (interests > 0 ? static_cast<double>(DELTA(retransmissions)) / interests : 0) << "\t"
+         << DELTA(timeouts) << "\t" << DELTA(nacks) << "\t"
+         << flow.second.app->GetRtt().ToDouble(Time::MS) << "\t" << flow.second.app->GetRto().ToDouble(Time::MS)
+         << "\n";
+
+#undef DELTA
+    }
+  }
+
+protected:
+  struct Flow {
+    Ptr<ConsumerAimd> app;
+    ConsumerAimd::Counters last; // counters at the previous print
+    double maxWindow = 0;
+  };
+
+  static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<FlowTracer>>>>& Registry() {
+    static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<FlowTracer>>>> tracers;
+    return tracers;
+  }
+
+  static std::shared_ptr<std::ostream> OpenStream(const std::string& file) {
+    if (file == "-") {
+      return std::shared_ptr<std::ostream>(&std::cout, std::bind([] {}));
+    }
+
+    std::shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!os->is_open()) {
+      std::cerr << "File " << file << " cannot be opened for writing. Tracing disabled\n";
+      return nullptr;
+    }
+    return os;
+  }
+
+  void Connect() {
+    for (uint32_t i = 0; i < m_nodePtr->GetNApplications(); i++) {
+      Ptr<ConsumerAimd> app = DynamicCast<ConsumerAimd>(m_nodePtr->GetApplication(i));
+      if (app == 0) {
+        continue;
+      }
+      Flow& flow = m_flows[app->GetId()];
+      flow.app = app;
+      app->TraceConnectWithoutContext("Window", MakeCallback(&FlowTracer::Window, this));
+    }
+  }
+
+  void SetAveragingPeriod(const Time& period) {
+    m_period = period;
+    m_printEvent.Cancel();
+    m_printEvent = Simulator::Schedule(m_period, &FlowTracer::PeriodicPrinter, this);
+  }
+
+  void PeriodicPrinter() {
+    Print(*m_os);
+    Reset();
+    m_printEvent = Simulator::Schedule(m_period, &FlowTracer::PeriodicPrinter, this);
+  }
+
+  void Reset() {
+    for (std::pair<const uint32_t, Flow>& flow : m_flows) {
+      flow.second.last = flow.second.app->GetCounters();
+      flow.second.maxWindow = flow.second.app->GetWindow();
+    }
+  }
+
+  void Window(Ptr<App> app, double window, uint32_t) {
+    auto flow = m_flows.find(app->GetId());
+    if (flow != m_flows.end()) {
+      flow->second.maxWindow = std::max(flow->second.maxWindow, window);
+    }
+  }
+
+protected:
+  Ptr<Node> m_nodePtr;
+  std::string m_node;
+  std::shared_ptr<std::ostream> m_os;
+
+  Time m_period;
+  EventId m_printEvent;
+
+  std::map<uint32_t, Flow> m_flows;
+};
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_FLOW_TRACER_HPP
@@ -0,0 +1,458 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_MEMORY_ACCOUNTING_HPP
+#define NDNSIM_SCRATCH_CUSTOM_MEMORY_ACCOUNTING_HPP
+
+#include "ns3/map-scheduler.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/ptr.h"
+#include "ns3/queue.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief MapScheduler that counts the pending events of every context (node id)
+ *
+ * Installed by MemoryAccounting; the counts are kept in GetPending(), the last entry is
+ * for events scheduled without a node context.
+*/
+class CountingMapScheduler : public MapScheduler {
+public:
+  static TypeId GetTypeId() {
+    static TypeId tid = TypeId("ns3::ndn::custom::CountingMapScheduler")
+      .SetParent<MapScheduler>()
+      .SetGroupName("Ndn")
+      .AddConstructor<CountingMapScheduler>();
+    return tid;
+  }
+
+  static std::vector<uint64_t>& GetPending() {
+    static std::vector<uint64_t> pending(1, 0);
+    return pending;
+  }
+
+  void Insert(const Scheduler::Event& ev) override {
+    Pending(ev.key.m_context)++;
+    MapScheduler::Insert(ev);
+  }
+
+  Scheduler::Event RemoveNext() override {
+    Scheduler::Event ev = MapScheduler::RemoveNext();
+    Pending(ev.key.m_context)--;
+    return ev;
+  }
+
+  void Remove(const Scheduler::Event& ev) override {
+    Pending(ev.key.m_context)--;
+    MapScheduler::Remove(ev);
+  }
+
+private:
+  static uint64_t& Pending(uint32_t context) {
+    std::vector<uint64_t>& pending = GetPending();
+    if (context == Simulator::NO_CONTEXT) {
+      return pending.back();
+    }
+    if (context + 1 >= pending.size()) {
+      uint64_t global = pending.back();
+      pending.back() = 0;
+      pending.resize(context + 2, 0);
+      pending.back() = global;
+    }
+    return pending[context];
+  }
+};
+
+NS_OBJECT_ENSURE_REGISTERED(CountingMapScheduler);
+
+/**
+ * \brief Live bytes and object counts per subsystem and per node, with peaks
+ *
+ * Every period the CS, PIT, FIB and name tree of each node are walked, the TxQueue of
+ * each net device is read and the pending events are taken from CountingMapScheduler
+ * (installed as the simulator scheduler by Install). Bytes are estimates: sizeof of the
+ * table entries and packet objects, the wire size of the stored packets and a fixed
+ * overhead per container node, so they show where memory goes and how it scales with
+ * setCsSize or the topology, not the exact heap usage. Peaks are the largest sampled
+ * values, with the time of the sample.
+ *
+ * Tracer buffers and other memory the accounting cannot see are reported through
+ * AddProbe; probes and events without a node context are accounted to the "-" row.
+ *
+ * Get, GetTotal and Sample can be called at any time during the run. The summary is
+ * written when the simulator is destroyed:
+ *
+ *     Node Subsystem Objects Bytes PeakObjects PeakBytes PeakTime
+ *
+ * with a Total row per subsystem (peak of the sum over nodes, not the sum of the peaks)
+ * and the process RSS for comparison. With samples set, every sample is also written
+ * as "Time Node Subsystem Objects Bytes" rows.
+*/
+class MemoryAccounting : public SimpleRefCount<MemoryAccounting> {
+public:
+  enum Subsystem {
+    CS,
+    PIT,
+    FIB,
+    NAME_TREE,
+    QUEUES,
+    EVENTS,
+    TRACERS,
+    ALL, // sum of the subsystems above
+    N_SUBSYSTEMS
+  };
+
+  struct Amount {
+    uint64_t objects = 0;
+    uint64_t bytes = 0;
+  };
+
+  struct Usage {
+    uint64_t objects = 0;
+    uint64_t bytes = 0;
+    uint64_t peakObjects = 0;
+    uint64_t peakBytes = 0;
+    Time peakTime;
+  };
+
+  static constexpr uint32_t GLOBAL = 0xFFFFFFFF; // row of the probes and events without a node
+
+  static void Install(const std::string& file = "-", Time period = Seconds(1.0), bool samples = false) {
+    std::shared_ptr<std::ostream> outputStream = OpenStream(file);
+    if (outputStream == nullptr) {
+      return;
+    }
+
+    ObjectFactory scheduler;
+    scheduler.SetTypeId(CountingMapScheduler::GetTypeId());
+    Simulator::SetScheduler(scheduler);
+
+    if (Registry().empty()) {
+      Simulator::ScheduleDestroy(&MemoryAccounting::PrintAll);
+    }
+    Registry().clear();
+    Ptr<MemoryAccounting> accounting = Create<MemoryAccounting>(outputStream, samples);
+    accounting->SetPeriod(period);
+    Registry().push_back(accounting);
+  }
+
+  /**
+   * \brief Explicit request to stop accounting (without printing)
+  */
+  static void Destroy() {
+    Registry().clear();
+  }
+
+  /**
+   * \brief Account what probe reports to subsystem (usually TRACERS) at every sample
+  */
+  static void AddProbe(Subsystem subsystem, std::function<Amount()> probe) {
+    Probes().push_back(std::make_tuple(subsystem, probe));
+  }
+
+  /**
+   * \brief Take a sample now, so that Get and GetTotal return current values
+  */
+  static void Sample() {
+    if (!Registry().empty()) {
+      Registry().front()->Update();
+    }
+  }
+
+  /**
+   * \brief Usage of node (or GLOBAL) at the last sample
+  */
+  static Usage Get(uint32_t nodeId, Subsystem subsystem) {
+    if (Registry().empty()) {
+      return Usage();
+    }
+    const MemoryAccounting& accounting = *Registry().front();
+    if (nodeId == GLOBAL) {
+      return accounting.m_global[subsystem];
+    }
+    return nodeId < accounting.m_usage.size() ? accounting.m_usage[nodeId][subsystem] : Usage();
+  }
+
+  /**
+   * \brief Usage summed over all nodes at the last sample
+  */
+  static Usage GetTotal(Subsystem subsystem) {
+    return Registry().empty() ? Usage() : Registry().front()->m_total[subsystem];
+  }
+
+  static const char* GetName(Subsystem subsystem) {
+    static const char* names[N_SUBSYSTEMS] = { "Cs", "Pit", "Fib", "NameTree", "Queues", "Events", "Tracers", "All" };
+    return names[subsystem];
+  }
+
+  /**
+   * \brief Resident set size of the process and its peak (Linux, 0 elsewhere)
+  */
+  static void GetProcessRss(uint64_t& current, uint64_t& peak) {
+    current = peak = 0;
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size, resident;
+    if (statm >> size >> resident) {
+      current = resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    while (status >> key) {
+      if (key == "VmHWM:" && status >> peak) {
+        peak *= 1024;
+        break;
+      }
+      status.ignore(256, '\n');
+    }
+  }
+
+  MemoryAccounting(std::shared_ptr<std::ostream> os, bool samples)
+    : m_os(os)
+    , m_samples(samples) {
+    if (m_samples) {
+      *m_os << "Time" << "\t" << "Node" << "\t" << "Subsystem" << "\t" << "Objects" << "\t" << "Bytes" << "\n";
+    }
+  }
+
+  ~MemoryAccounting() {
+    Simulator::Cancel(m_sampleEvent);
+  }
+
+  void PrintHeader(std::ostream& os) const {
+    os << "Node" << "\t" << "Subsystem" << "\t" << "Objects" << "\t" << "Bytes" << "\t" << "PeakObjects" << "\t"
+       << "PeakBytes" << "\t" << "PeakTime";
+  }
+
+  void Print(std::ostream& os) const {
+    for (std::size_t row = 0; row <= m_usage.size(); row++) {
+      const std::array<Usage, N_SUBSYSTEMS>& usage = row < m_usage.size() ? m_usage[row] : m_global;
+      std::string node = row < m_usage.size() ? std::to_string(row) : "-";
+      for (int s = 0; s < N_SUBSYSTEMS; s++) {
+        if (usage[s].peakObjects == 0 && usage[s].peakBytes == 0) {
+          continue;
+        }
+        PrintUsage(os, node, static_cast<Subsystem>(s), usage[s]);
+      }
+    }
+    for (int s = 0; s < N_SUBSYSTEMS; s++) {
+      PrintUsage(os, "Total", static_cast<Subsystem>(s), m_total[s]);
+    }
+
+    uint64_t rss, peakRss;
+    GetProcessRss(rss, peakRss);
+    os << "Process-Rss : " << rss << " (peak " << peakRss << ")\n";
+  }
+
+protected:
+  // allocator and container node overhead assumed per heap object (tree, list or hash node)
+  static constexpr uint64_t NODE_OVERHEAD = 32;
+  // EventImpl with its bound arguments, roughly
+  static constexpr uint64_t EVENT_IMPL = 64;
+
+  static std::list<Ptr<MemoryAccounting>>& Registry() {
+    static std::list<Ptr<MemoryAccounting>> accounting;
+    return accounting;
+  }
+
+  static std::list<std::tuple<Subsystem, std::function<Amount()>>>& Probes() {
+    static std::list<std::tuple<Subsystem, std::function<Amount()>>> probes;
+    return probes;
+  }
+
+  static std::shared_ptr<std::ostream> OpenStream(const std::string& file) {
+    if (file == "-") {
+      return std::shared_ptr<std::ostream>(&std::cout, std::bind([] {}));
+    }
+
+    std::shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!os->is_open()) {
+      std::cerr << "File " << file << " cannot be opened for writing. Memory accounting disabled\n";
+      return nullptr;
+    }
+    return os;
+  }
+
+  // nodes are already disposed when this runs, so the values are those of the last sample
+  static void PrintAll() {
+    for (const Ptr<MemoryAccounting>& accounting : Registry()) {
+      accounting->PrintHeader(*accounting->m_os);
+      *accounting->m_os << "\n";
+      accounting->Print(*accounting->m_os);
+    }
+    Registry().clear();
+  }
+
+  static void PrintUsage(std::ostream& os, const std::string& node, Subsystem subsystem, const Usage& u) {
+    os << node << "\t" << GetName(subsystem) << "\t" << u.objects << "\t" << u.bytes << "\t" << u.peakObjects
+       << "\t" << u.peakBytes << "\t" << u.peakTime.ToDouble(Time::S) << "\n";
+  }
+
+  static void Record(Usage& usage, const Amount& amount, const Time& now) {
+    usage.objects = amount.objects;
+    usage.bytes = amount.bytes;
+    usage.peakObjects = std::max(usage.peakObjects, amount.objects);
+    if (amount.bytes > usage.peakBytes) {
+      usage.peakBytes = amount.bytes;
+      usage.peakTime = now;
+    }
+  }
+
+  static uint64_t NameBytes(const Name& prefix) {
+    uint64_t bytes = sizeof(Name);
+    for (const ::ndn::name::Component& component : prefix) {
+      bytes += sizeof(::ndn::name::Component) + component.size();
+    }
+    return bytes;
+  }
+
+  static void Measure(Ptr<Node> node, std::array<Amount, N_SUBSYSTEMS>& out) {
+    Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+    if (l3 != 0) {
+      nfd::Forwarder& forwarder = *l3->getForwarder();
+
+      for (const nfd::cs::Entry& entry : forwarder.getCs()) {
+        out[CS].objects++;
+        out[CS].bytes += sizeof(nfd::cs::Entry) + 2 * NODE_OVERHEAD + sizeof(Data) + entry.getData().wireEncode().size();
+      }
+
+      for (const nfd::pit::Entry& entry : forwarder.getPit()) {
+        out[PIT].objects++;
+        out[PIT].bytes += sizeof(nfd::pit::Entry) + NODE_OVERHEAD + sizeof(Interest)
+                          + entry.getInterest().wireEncode().size();
+        for (const nfd::pit::InRecord& record : entry.getInRecords()) {
+          out[PIT].bytes += sizeof(record) + NODE_OVERHEAD;
+        }
+        for (const nfd::pit::OutRecord& record : entry.getOutRecords()) {
+          out[PIT].bytes += sizeof(record) + NODE_OVERHEAD;
+        }
+      }
+
+      for (const nfd::fib::Entry& entry : forwarder.getFib()) {
+        out[FIB].objects++;
+        out[FIB].bytes += sizeof(nfd::fib::Entry) + NODE_OVERHEAD
+                          + entry.getNextHops().size() * sizeof(nfd::fib::NextHop);
+      }
+
+      const nfd::name_tree::NameTree& nameTree = forwarder.getNameTree();
+      out[NAME_TREE].bytes += nameTree.getNBuckets() * sizeof(void*);
+      for (const nfd::name_tree::Entry& entry : nameTree) {
+        out[NAME_TREE].objects++;
+        out[NAME_TREE].bytes += sizeof(nfd::name_tree::Entry) + sizeof(nfd::name_tree::Node) + NODE_OVERHEAD
+                                + NameBytes(entry.getName());
+      }
+    }
+
+    for (uint32_t d = 0; d < node->GetNDevices(); d++) {
+      PointerValue txQueue;
+      if (!node->GetDevice(d)->GetAttributeFailSafe("TxQueue", txQueue) || txQueue.Get<Queue<Packet>>() == 0) {
+        continue;
+      }
+      Ptr<Queue<Packet>> queue = txQueue.Get<Queue<Packet>>();
+      out[QUEUES].objects += queue->GetNPackets();
+      out[QUEUES].bytes += queue->GetNPackets() * (sizeof(Packet) + NODE_OVERHEAD) + queue->GetNBytes();
+    }
+  }
+
+  void SetPeriod(const Time& period) {
+    m_period = period;
+    m_sampleEvent.Cancel();
+    m_sampleEvent = Simulator::Schedule(m_period, &MemoryAccounting::PeriodicSample, this);
+  }
+
+  void PeriodicSample() {
+    Update();
+    m_sampleEvent = Simulator::Schedule(m_period, &MemoryAccounting::PeriodicSample, this);
+  }
+
+  void Update() {
+    Time now = Simulator::Now();
+    uint32_t nNodes = NodeList::GetNNodes();
+    if (m_usage.size() < nNodes) {
+      m_usage.resize(nNodes);
+    }
+
+    const std::vector<uint64_t>& pending = CountingMapScheduler::GetPending();
+    std::array<Amount, N_SUBSYSTEMS> total;
+
+    for (uint32_t row = 0; row <= nNodes; row++) {
+      std::array<Amount, N_SUBSYSTEMS> amounts;
+      if (row < nNodes) {
+        Measure(NodeList::GetNode(row), amounts);
+        amounts[EVENTS].objects = row + 1 < pending.size() ? pending[row] : 0;
+      }
+      else {
+        amounts[EVENTS].objects = pending.back();
+        for (const std::tuple<Subsystem, std::function<Amount()>>& probe : Probes()) {
+          Amount amount = std::get<1>(probe)();
+          amounts[std::get<0>(probe)].objects += amount.objects;
+          amounts[std::get<0>(probe)].bytes += amount.bytes;
+        }
+      }
+      amounts[EVENTS].bytes = amounts[EVENTS].objects * (sizeof(Scheduler::Event) + NODE_OVERHEAD + EVENT_IMPL);
+
+      for (int s = 0; s < ALL; s++) {
+        amounts[ALL].objects += amounts[s].objects;
+        amounts[ALL].bytes += amounts[s].bytes;
+      }
+      std::array<Usage, N_SUBSYSTEMS>& usage = row < nNodes ? m_usage[row] : m_global;
+      for (int s = 0; s < N_SUBSYSTEMS; s++) {
+        Record(usage[s], amounts[s], now);
+        total[s].objects += amounts[s].objects;
+        total[s].bytes += amounts[s].bytes;
+
+        if (m_samples && (amounts[s].objects > 0 || amounts[s].bytes > 0)) {
+          *m_os << now.ToDouble(Time::S) << "\t" << (row < nNodes ? std::to_string(row) : "-") << "\t"
+                << GetName(static_cast<Subsystem>(s)) << "\t" << amounts[s].objects << "\t" << amounts[s].bytes
+                << "\n";
+        }
+      }
+    }
+
+    for (int s = 0; s < N_SUBSYSTEMS; s++) {
+      Record(m_total[s], total[s], now);
+    }
+  }
+
+protected:
+  std::shared_ptr<std::ostream> m_os;
+  bool m_samples;
+
+  Time m_period;
+  EventId m_sampleEvent;
+
+  std::vector<std::array<Usage, N_SUBSYSTEMS>> m_usage; // per node id
+  std::array<Usage, N_SUBSYSTEMS> m_global;
+  std::array<Usage, N_SUBSYSTEMS> m_total;
+};
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_MEMORY_ACCOUNTING_HPP
@@ -0,0 +1,224 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_PACKET_CLASSIFY_HPP
+#define NDNSIM_SCRATCH_CUSTOM_PACKET_CLASSIFY_HPP
+
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief What a link-layer packet carries, read from its first bytes
+*/
+struct PacketClass {
+  enum Type : uint8_t {
+    Other = 0,
+    Interest,
+    Data,
+    Nack,
+    Lp, // LpPacket without a network-layer fragment (e.g. an idle ack)
+  };
+
+  Type type = Other;
+  std::string prefix; // first components of the name, "/" if none was found
+  uint64_t nameHash = 0; // HashName of the whole name, 0 if it did not fit in the copied bytes
+
+  static const char* TypeName(Type type) {
+    switch (type) {
+    case Interest:
+      return "Interest";
+    case Data:
+      return "Data";
+    case Nack:
+      return "Nack";
+    case Lp:
+      return "Lp";
+    default:
+      return "Other";
+    }
+  }
+};
+
+/**
+ * \brief FNV-1a over the value of a Name TLV, i.e. Name::wireEncode().value()
+*/
+inline uint64_t HashName(const uint8_t* value, std::size_t length) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (std::size_t i = 0; i < length; i++) {
+    hash = (hash ^ value[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+namespace detail {
+
+constexpr uint64_t TLV_INTEREST = 0x05;
+constexpr uint64_t TLV_DATA = 0x06;
+constexpr uint64_t TLV_NAME = 0x07;
+constexpr uint64_t TLV_LP_PACKET = 0x64;
+constexpr uint64_t TLV_LP_FRAGMENT = 0x50;
+constexpr uint64_t TLV_LP_NACK = 0x0320;
+
+inline bool ReadVarNumber(const uint8_t*& pos, const uint8_t* end, uint64_t& value) {
+  if (pos >= end) {
+    return false;
+  }
+  uint8_t first = *pos++;
+  int length = first < 253 ? 0 : first == 253 ? 2 : first == 254 ? 4 : 8;
+  if (length == 0) {
+    value = first;
+    return true;
+  }
+  if (end - pos < length) {
+    return false;
+  }
+  value = 0;
+  for (int i = 0; i < length; i++) {
+    value = (value << 8) | *pos++;
+  }
+  return true;
+}
+
+/**
+ * \brief Read a TLV header; value points to the (possibly truncated) value afterwards
+*/
+inline bool ReadTlv(const uint8_t*& pos, const uint8_t* end, uint64_t& type, const uint8_t*& value,
+                    uint64_t& length) {
+  if (!ReadVarNumber(pos, end, type) || !ReadVarNumber(pos, end, length)) {
+    return false;
+  }
+  value = pos;
+  pos = static_cast<uint64_t>(end - pos) < length ? end : pos + length;
+  return true;
+}
+
+inline void AppendComponent(std::string& out, const uint8_t* value, std::size_t length) {
+  static const char hex[] = "0123456789ABCDEF";
+  out += '/';
+  for (std::size_t i = 0; i < length; i++) {
+    uint8_t c = value[i];
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+        || c == '-' || c == '.' || c == '_' || c == '~') {
+      out += static_cast<char>(c);
+    }
+    else {
+      out += '%';
+      out += hex[c >> 4];
+      out += hex[c & 0xf];
+    }
+  }
+}
+
+/**
+ * \brief Find the Name inside an Interest/Data value and keep its first depth components
+*/
+inline void ReadPrefix(const uint8_t* pos, const uint8_t* end, std::size_t depth, PacketClass& out) {
+  uint64_t type = 0, length = 0;
+  const uint8_t* value = nullptr;
+  while (ReadTlv(pos, end, type, value, length)) {
+    if (type != TLV_NAME) {
+      continue;
+    }
+    const uint8_t* nameEnd = static_cast<uint64_t>(end - value) < length ? end : value + length;
+    if (static_cast<uint64_t>(nameEnd - value) == length) {
+      out.nameHash = HashName(value, length);
+    }
+    for (std::size_t i = 0; i < depth && ReadTlv(value, nameEnd, type, pos, length); i++) {
+      if (static_cast<uint64_t>(nameEnd - pos) < length) {
+        break; // component cut off by the copied window
+      }
+      AppendComponent(out.prefix, pos, length);
+    }
+    return;
+  }
+}
+
+} // namespace detail
+
+/**
+ * \brief Classify an NDN wire encoding (bare Interest/Data or LpPacket)
+ *
+ * Only TLV headers are walked, nothing is decoded or allocated besides the prefix
+ * string; a truncated buffer still gives the type and as much of the name as it holds.
+*/
+inline void ClassifyWire(const uint8_t* buffer, std::size_t size, std::size_t depth, PacketClass& out) {
+  out.type = PacketClass::Other;
+  out.prefix.clear();
+  out.nameHash = 0;
+
+  const uint8_t* pos = buffer;
+  const uint8_t* end = buffer + size;
+  uint64_t type = 0, length = 0;
+  const uint8_t* value = nullptr;
+  if (!detail::ReadTlv(pos, end, type, value, length)) {
+    return;
+  }
+
+  bool isNack = false;
+  if (type == detail::TLV_LP_PACKET) {
+    out.type = PacketClass::Lp;
+    const uint8_t* lpEnd = pos;
+    pos = value;
+    bool haveFragment = false;
+    while (detail::ReadTlv(pos, lpEnd, type, value, length)) {
+      if (type == detail::TLV_LP_NACK) {
+        isNack = true;
+      }
+      else if (type == detail::TLV_LP_FRAGMENT) {
+        haveFragment = true;
+        break; // the fragment is the last field
+      }
+    }
+    if (!haveFragment) {
+      return;
+    }
+    pos = value;
+    if (!detail::ReadTlv(pos, end, type, value, length)) {
+      return;
+    }
+  }
+
+  if (type == detail::TLV_INTEREST) {
+    out.type = isNack ? PacketClass::Nack : PacketClass::Interest;
+  }
+  else if (type == detail::TLV_DATA) {
+    out.type = PacketClass::Data;
+  }
+  else {
+    return;
+  }
+  detail::ReadPrefix(value, pos, depth, out);
+  if (out.prefix.empty()) {
+    out.prefix = "/";
+  }
+}
+
+/**
+ * \brief Classify an ns-3 packet as seen by a net device queue
+ * \param skip link-layer header bytes in front of the NDN block (2 for PPP)
+*/
+inline void Classify(Ptr<const Packet> packet, uint32_t skip, std::size_t depth, PacketClass& out) {
+  uint8_t buffer[256];
+  uint32_t size = packet->CopyData(buffer, sizeof(buffer));
+  if (size <= skip) {
+    out.type = PacketClass::Other;
+    out.prefix = "/";
+    out.nameHash = 0;
+    return;
+  }
+  ClassifyWire(buffer + skip, size - skip, depth, out);
+  if (out.prefix.empty()) {
+    out.prefix = "/";
+  }
+}
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_PACKET_CLASSIFY_HPP
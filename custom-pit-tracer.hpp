@@ -0,0 +1,270 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_PIT_TRACER_HPP
+#define NDNSIM_SCRATCH_CUSTOM_PIT_TRACER_HPP
+
+#include "ns3/names.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/strategy-info.hpp"
+
+#include "custom-trace-filter.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief PIT tracer: occupancy, aggregation, satisfaction and expiry per node
+ *
+ * Every averaging period one line per metric is printed:
+ *
+ * - PitSize: entries in the PIT at print time
+ * - PitPeak: largest PIT seen during the period (sampled on every incoming interest)
+ * - Aggregated: interests that joined an entry already pending for another face
+ * - Satisfied: entries satisfied by data
+ * - Expired: entries removed because their lifetime ended
+ * - AvgLifetimeMs: mean time between the creation of an entry and its satisfaction/expiry
+ *
+ * Counters are updated from the forwarder signals (beforeSatisfyInterest,
+ * beforeExpirePendingInterest) and the L3Protocol InInterests trace source. With a
+ * TraceFilter only entries and interests under its prefix (and sampled) are counted;
+ * PitSize and PitPeak always describe the whole table. The creation time is stored on the
+ * entry itself when the tracer first sees it, so retransmissions renewing the in-records do
+ * not shorten the measured lifetime.
+*/
+class PitTracer : public SimpleRefCount<PitTracer> {
+public:
+  static void InstallAll(const std::string& file, Time averagingPeriod = Seconds(0.5)) {
+    NodeContainer nodes;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      nodes.Add(*node);
+    }
+    Install(nodes, file, averagingPeriod);
+  }
+
+  static void Install(const NodeContainer& nodes, const std::string& file, Time averagingPeriod = Seconds(0.5),
+                      const TraceFilter& filter = TraceFilter()) {
+    std::list<Ptr<PitTracer>> tracers;
+    std::shared_ptr<std::ostream> outputStream = OpenStream(file);
+    if (outputStream == nullptr) {
+      return;
+    }
+
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+      if ((*node)->GetObject<L3Protocol>() == 0) {
+        continue;
+      }
+      tracers.push_back(Install(*node, outputStream, averagingPeriod, filter));
+    }
+
+    if (tracers.size() > 0) {
+      tracers.front()->PrintHeader(*outputStream);
+      *outputStream << "\n";
+    }
+
+    Registry().push_back(std::make_tuple(outputStream, tracers));
+  }
+
+  static Ptr<PitTracer> Install(Ptr<Node> node, std::shared_ptr<std::ostream> outputStream,
+                                Time averagingPeriod = Seconds(0.5), const TraceFilter& filter = TraceFilter()) {
+    Ptr<PitTracer> trace = Create<PitTracer>(outputStream, node, filter);
+    trace->SetAveragingPeriod(averagingPeriod);
+    return trace;
+  }
+
+  /**
+   * \brief Explicit request to remove all statically created tracers
+  */
+  static void Destroy() {
+    Registry().clear();
+  }
+
+  PitTracer(std::shared_ptr<std::ostream> os, Ptr<Node> node, const TraceFilter& filter = TraceFilter())
+    : m_nodePtr(node)
+    , m_os(os)
+    , m_filter(filter)
+    , m_passAll(filter.IsPassAll()) {
+    m_node = std::to_string(m_nodePtr->GetId());
+    std::string name = Names::FindName(node);
+    if (!name.empty()) {
+      m_node = name;
+    }
+    Connect();
+    Reset();
+  }
+
+  ~PitTracer() {
+    Simulator::Cancel(m_printEvent);
+  }
+
+  void PrintHeader(std::ostream& os) const {
+    os << "Time" << "\t" << "Node" << "\t" << "Type" << "\t" << "Value";
+  }
+
+  void Print(std::ostream& os) const {
+    Time time = Simulator::Now();
+    double avgLifetime = m_stats.lifetimeCount == 0 ? 0 : m_stats.lifetimeSumMs / m_stats.lifetimeCount;
+
+#define PRINTER(printName, value) \
+  os << time.ToDouble(Time::S) << "\t" << m_node << "\t" << printName << "\t" << value << "\n";
+
+    PRINTER("PitSize", m_pit->size());
+    PRINTER("PitPeak", std::max<uint64_t>(m_stats.peak, m_pit->size()));
+    PRINTER("Aggregated", m_stats.aggregated);
+    PRINTER("Satisfied", m_stats.satisfied);
+    PRINTER("Expired", m_stats.expired);
+    PRINTER("AvgLifetimeMs", avgLifetime);
+
+#undef PRINTER
+  }
+
+protected:
+  static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<PitTracer>>>>& Registry() {
+    static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<PitTracer>>>> tracers;
+    return tracers;
+  }
+
+  static std::shared_ptr<std::ostream> OpenStream(const std::string& file) {
+    if (file == "-") {
+      return std::shared_ptr<std::ostream>(&std::cout, std::bind([] {}));
+    }
+
+    std::shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!os->is_open()) {
+      std::cerr << "File " << file << " cannot be opened for writing. Tracing disabled\n";
+      return nullptr;
+    }
+    return os;
+  }
+
+  void Connect() {
+    Ptr<L3Protocol> l3 = m_nodePtr->GetObject<L3Protocol>();
+    std::shared_ptr<nfd::Forwarder> forwarder = l3->getForwarder();
+    m_pit = &forwarder->getPit();
+
+    l3->TraceConnectWithoutContext("InInterests", MakeCallback(&PitTracer::InInterest, this));
+    m_satisfiedConn = forwarder->beforeSatisfyInterest.connect(
+      [this](const nfd::pit::Entry& entry, const Face&, const Data&) {
+        if (!m_passAll && !m_filter.Matches(entry.getName())) {
+          return;
+        }
+        m_stats.satisfied++;
+        AddLifetime(entry);
+      });
+    m_expiredConn = forwarder->beforeExpirePendingInterest.connect(
+      [this](const nfd::pit::Entry& entry) {
+        if (!m_passAll && !m_filter.Matches(entry.getName())) {
+          return;
+        }
+        m_stats.expired++;
+        AddLifetime(entry);
+      });
+  }
+
+  void SetAveragingPeriod(const Time& period) {
+    m_period = period;
+    m_printEvent.Cancel();
+    m_printEvent = Simulator::Schedule(m_period, &PitTracer::PeriodicPrinter, this);
+  }
+
+  void PeriodicPrinter() {
+    Print(*m_os);
+    Reset();
+    m_printEvent = Simulator::Schedule(m_period, &PitTracer::PeriodicPrinter, this);
+  }
+
+  void Reset() {
+    m_stats = Stats();
+  }
+
+  void InInterest(const Interest& interest, const Face& face) {
+    m_stats.peak = std::max<uint64_t>(m_stats.peak, m_pit->size());
+    if (!m_passAll && !m_filter.Matches(interest.getName())) {
+      return;
+    }
+
+    // pending for another downstream face => this interest was aggregated
+    std::shared_ptr<nfd::pit::Entry> entry = m_pit->find(interest);
+    if (entry == nullptr) {
+      return;
+    }
+    std::pair<CreatedInfo*, bool> created = entry->insertStrategyInfo<CreatedInfo>();
+    if (created.second) {
+      created.first->since = time::steady_clock::now();
+    }
+    for (const nfd::pit::InRecord& record : entry->getInRecords()) {
+      if (&record.getFace() != &face) {
+        m_stats.aggregated++;
+        return;
+      }
+    }
+  }
+
+  void AddLifetime(const nfd::pit::Entry& entry) {
+    const CreatedInfo* created = entry.getStrategyInfo<CreatedInfo>();
+    if (created == nullptr) {
+      return;
+    }
+    m_stats.lifetimeSumMs +=
+      time::duration_cast<time::microseconds>(time::steady_clock::now() - created->since).count() / 1000.0;
+    m_stats.lifetimeCount++;
+  }
+
+protected:
+  /**
+   * \brief Time the tracer first saw a PIT entry; InInterests fires after the forwarder
+   * has inserted the entry, so this is its creation time
+  */
+  class CreatedInfo : public nfd::fw::StrategyInfo {
+  public:
+    static constexpr int getTypeId() {
+      return 9032;
+    }
+
+    time::steady_clock::TimePoint since;
+  };
+
+  Ptr<Node> m_nodePtr;
+  std::string m_node;
+  std::shared_ptr<std::ostream> m_os;
+  nfd::Pit* m_pit;
+  TraceFilter m_filter;
+  bool m_passAll;
+
+  Time m_period;
+  EventId m_printEvent;
+
+  ::ndn::util::signal::ScopedConnection m_satisfiedConn;
+  ::ndn::util::signal::ScopedConnection m_expiredConn;
+
+  struct Stats {
+    uint64_t peak = 0;
+    uint64_t aggregated = 0;
+    uint64_t satisfied = 0;
+    uint64_t expired = 0;
+    double lifetimeSumMs = 0;
+    uint64_t lifetimeCount = 0;
+  } m_stats;
+};
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_PIT_TRACER_HPP
@@ -0,0 +1,223 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_POPULARITY_TRACER_HPP
+#define NDNSIM_SCRATCH_CUSTOM_POPULARITY_TRACER_HPP
+
+#include "ns3/names.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "custom-packet-classify.hpp"
+#include "heavy-hitters.hpp"
+
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief Most requested names and prefixes of every node, in fixed memory
+ *
+ * Interest arrivals (L3Protocol InInterests, app faces included) and CS hits (forwarder
+ * afterCsHit) are counted per full name and per prefix of prefixDepth components in
+ * HeavyHitters tables: a count-min sketch of SketchDepth x SketchWidth counters and the
+ * top k names. Nothing is logged per packet and memory does not depend on the catalog
+ * size. Every period the top k of each table are printed and the tables are reset:
+ *
+ *     Time Node Event Level Rank Name Count Share
+ *
+ * Event is Interest or CsHit, Level is Name or Prefix, Count the estimated number of
+ * events of the period (an overestimate by at most ~e/SketchWidth of the period total)
+ * and Share is Count over all the events of that kind on the node in the period.
+*/
+class PopularityTracer : public SimpleRefCount<PopularityTracer> {
+public:
+  static constexpr uint32_t SketchWidth = 2048;
+  static constexpr uint32_t SketchDepth = 4;
+
+  static void InstallAll(const std::string& file, Time averagingPeriod = Seconds(1.0), uint32_t k = 10,
+                         std::size_t prefixDepth = 1) {
+    NodeContainer nodes;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      nodes.Add(*node);
+    }
+    Install(nodes, file, averagingPeriod, k, prefixDepth);
+  }
+
+  static void Install(const NodeContainer& nodes, const std::string& file, Time averagingPeriod = Seconds(1.0),
+                      uint32_t k = 10, std::size_t prefixDepth = 1) {
+    std::list<Ptr<PopularityTracer>> tracers;
+    std::shared_ptr<std::ostream> outputStream = OpenStream(file);
+    if (outputStream == nullptr) {
+      return;
+    }
+
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+      if ((*node)->GetObject<L3Protocol>() == 0) {
+        continue;
+      }
+      tracers.push_back(Install(*node, outputStream, averagingPeriod, k, prefixDepth));
+    }
+
+    if (tracers.size() > 0) {
+      tracers.front()->PrintHeader(*outputStream);
+      *outputStream << "\n";
+    }
+
+    Registry().push_back(std::make_tuple(outputStream, tracers));
+  }
+
+  static Ptr<PopularityTracer> Install(Ptr<Node> node, std::shared_ptr<std::ostream> outputStream,
+                                       Time averagingPeriod = Seconds(1.0), uint32_t k = 10,
+                                       std::size_t prefixDepth = 1) {
+    Ptr<PopularityTracer> trace = Create<PopularityTracer>(outputStream, node, k, prefixDepth);
+    trace->SetAveragingPeriod(averagingPeriod);
+    return trace;
+  }
+
+  /**
+   * \brief Explicit request to remove all statically created tracers
+  */
+  static void Destroy() {
+    Registry().clear();
+  }
+
+  PopularityTracer(std::shared_ptr<std::ostream> os, Ptr<Node> node, uint32_t k = 10, std::size_t prefixDepth = 1)
+    : m_nodePtr(node)
+    , m_os(os)
+    , m_prefixDepth(prefixDepth)
+    , m_tables{ HeavyHitters(k, SketchWidth, SketchDepth), HeavyHitters(k, SketchWidth, SketchDepth),
+                HeavyHitters(k, SketchWidth, SketchDepth), HeavyHitters(k, SketchWidth, SketchDepth) } {
+    m_node = std::to_string(m_nodePtr->GetId());
+    std::string name = Names::FindName(node);
+    if (!name.empty()) {
+      m_node = name;
+    }
+    Connect();
+  }
+
+  ~PopularityTracer() {
+    Simulator::Cancel(m_printEvent);
+  }
+
+  void PrintHeader(std::ostream& os) const {
+    os << "Time" << "\t" << "Node" << "\t" << "Event" << "\t" << "Level" << "\t" << "Rank" << "\t" << "Name" << "\t"
+       << "Count" << "\t" << "Share";
+  }
+
+  void Print(std::ostream& os) const {
+    double time = Simulator::Now().ToDouble(Time::S);
+    static const char* events[] = { "Interest", "Interest", "CsHit", "CsHit" };
+    static const char* levels[] = { "Name", "Prefix", "Name", "Prefix" };
+
+    for (int t = 0; t < TABLES; t++) {
+      const HeavyHitters& table = m_tables[t];
+      uint32_t rank = 1;
+      for (const HeavyHitters::Item& item : table.Top()) {
+        os << time << "\t" << m_node << "\t" << events[t] << "\t" << levels[t] << "\t" << rank++ << "\t"
+           << item.name << "\t" << item.count << "\t"
+           << (table.Total() > 0 ? static_cast<double>(item.count) / table.Total() : 0) << "\n";
+      }
+    }
+  }
+
+protected:
+  enum Table { INTEREST_NAME, INTEREST_PREFIX, CS_HIT_NAME, CS_HIT_PREFIX, TABLES };
+
+  static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<PopularityTracer>>>>& Registry() {
+    static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<PopularityTracer>>>> tracers;
+    return tracers;
+  }
+
+  static std::shared_ptr<std::ostream> OpenStream(const std::string& file) {
+    if (file == "-") {
+      return std::shared_ptr<std::ostream>(&std::cout, std::bind([] {}));
+    }
+
+    std::shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!os->is_open()) {
+      std::cerr << "File " << file << " cannot be opened for writing. Tracing disabled\n";
+      return nullptr;
+    }
+    return os;
+  }
+
+  void Connect() {
+    Ptr<L3Protocol> l3 = m_nodePtr->GetObject<L3Protocol>();
+    std::shared_ptr<nfd::Forwarder> forwarder = l3->getForwarder();
+
+    l3->TraceConnectWithoutContext("InInterests", MakeCallback(&PopularityTracer::InInterest, this));
+    m_hitConn = forwarder->afterCsHit.connect([this](const Interest& interest, const Data&) {
+      Count(interest.getName(), CS_HIT_NAME);
+    });
+  }
+
+  void SetAveragingPeriod(const Time& period) {
+    m_period = period;
+    m_printEvent.Cancel();
+    m_printEvent = Simulator::Schedule(m_period, &PopularityTracer::PeriodicPrinter, this);
+  }
+
+  void PeriodicPrinter() {
+    Print(*m_os);
+    Reset();
+    m_printEvent = Simulator::Schedule(m_period, &PopularityTracer::PeriodicPrinter, this);
+  }
+
+  void Reset() {
+    for (HeavyHitters& table : m_tables) {
+      table.Reset();
+    }
+  }
+
+  void InInterest(const Interest& interest, const Face& face) {
+    Count(interest.getName(), INTEREST_NAME);
+  }
+
+  /**
+   * \brief Count name in the name table and its prefix in the next one; the URIs are
+   * only built for names entering a top k
+  */
+  void Count(const Name& name, int table) {
+    // the components are elements of the name's wire, so a prefix is a leading range of it
+    const Block& wire = name.wireEncode();
+    const uint8_t* end = wire.value() + wire.value_size();
+    const uint8_t* prefixEnd = m_prefixDepth < name.size() ? name[m_prefixDepth].wire() : end;
+
+    m_tables[table].Add(HashName(wire.value(), end - wire.value()), [&name] { return name.toUri(); });
+    m_tables[table + 1].Add(HashName(wire.value(), prefixEnd - wire.value()),
+                            [&name, this] { return name.getPrefix(m_prefixDepth).toUri(); });
+  }
+
+protected:
+  Ptr<Node> m_nodePtr;
+  std::string m_node;
+  std::shared_ptr<std::ostream> m_os;
+  std::size_t m_prefixDepth;
+
+  Time m_period;
+  EventId m_printEvent;
+
+  HeavyHitters m_tables[TABLES];
+
+  ::ndn::util::signal::ScopedConnection m_hitConn;
+};
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_POPULARITY_TRACER_HPP
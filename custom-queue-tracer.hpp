@@ -0,0 +1,310 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_QUEUE_TRACER_HPP
+#define NDNSIM_SCRATCH_CUSTOM_QUEUE_TRACER_HPP
+
+#include "ns3/names.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/pointer.h"
+#include "ns3/ptr.h"
+#include "ns3/queue.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/model/ndn-net-device-transport.hpp"
+
+#include "custom-packet-classify.hpp"
+#include "streaming-histogram.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief Per-face transmit queue tracer: occupancy, sojourn time and drop causes
+ *
+ * Hooks the Enqueue/Dequeue/Drop trace sources of every net device TxQueue of the node
+ * (devices without a TxQueue, e.g. IdealNetDevice, only report their Drop trace). Every
+ * averaging period one line per metric and face is printed:
+ *
+ *     Time Node Face Type Prefix Value
+ *
+ * - AvgLength: time-weighted average number of queued packets
+ * - MaxLength: largest queue length seen
+ * - LengthP50/P99: queue length found by arriving packets
+ * - SojournP50Ms/P90Ms/P99Ms: time from enqueue to dequeue
+ * - Enqueued: packets accepted by the queue
+ * - Drop-Interest/Drop-Data/Drop-Nack/...: drops per packet type and name prefix
+ *   (Prefix column, first PrefixDepth name components)
+ *
+ * Prefix is "-" for the rows that are not per prefix. Faces that saw no traffic during
+ * the period are not printed. Only dropped packets are decoded.
+*/
+class QueueTracer : public SimpleRefCount<QueueTracer> {
+public:
+  static void InstallAll(const std::string& file, Time averagingPeriod = Seconds(1.0), std::size_t prefixDepth = 1) {
+    NodeContainer nodes;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      nodes.Add(*node);
+    }
+    Install(nodes, file, averagingPeriod, prefixDepth);
+  }
+
+  static void Install(const NodeContainer& nodes, const std::string& file, Time averagingPeriod = Seconds(1.0),
+                      std::size_t prefixDepth = 1) {
+    std::list<Ptr<QueueTracer>> tracers;
+    std::shared_ptr<std::ostream> outputStream = OpenStream(file);
+    if (outputStream == nullptr) {
+      return;
+    }
+
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+      tracers.push_back(Install(*node, outputStream, averagingPeriod, prefixDepth));
+    }
+
+    if (tracers.size() > 0) {
+      tracers.front()->PrintHeader(*outputStream);
+      *outputStream << "\n";
+    }
+
+    Registry().push_back(std::make_tuple(outputStream, tracers));
+  }
+
+  static Ptr<QueueTracer> Install(Ptr<Node> node, std::shared_ptr<std::ostream> outputStream,
+                                  Time averagingPeriod = Seconds(1.0), std::size_t prefixDepth = 1) {
+    Ptr<QueueTracer> trace = Create<QueueTracer>(outputStream, node, prefixDepth);
+    trace->SetAveragingPeriod(averagingPeriod);
+    return trace;
+  }
+
+  /**
+   * \brief Explicit request to remove all statically created tracers
+  */
+  static void Destroy() {
+    Registry().clear();
+  }
+
+  QueueTracer(std::shared_ptr<std::ostream> os, Ptr<Node> node, std::size_t prefixDepth = 1)
+    : m_nodePtr(node)
+    , m_os(os)
+    , m_prefixDepth(prefixDepth) {
+    m_node = std::to_string(m_nodePtr->GetId());
+    std::string name = Names::FindName(node);
+    if (!name.empty()) {
+      m_node = name;
+    }
+    Connect();
+  }
+
+  ~QueueTracer() {
+    Simulator::Cancel(m_printEvent);
+  }
+
+  void PrintHeader(std::ostream& os) const {
+    os << "Time" << "\t" << "Node" << "\t" << "Face" << "\t" << "Type" << "\t" << "Prefix" << "\t" << "Value";
+  }
+
+  void Print(std::ostream& os) {
+    Time now = Simulator::Now();
+    double time = now.ToDouble(Time::S);
+
+    for (const std::unique_ptr<DeviceState>& device : m_devices) {
+      DeviceState& state = *device;
+      state.Advance(now);
+      if (state.enqueued == 0 && state.drops.empty() && state.current == 0) {
+        continue;
+      }
+
+      double elapsed = (now - m_periodStart).GetSeconds();
+      double avgLength = elapsed > 0 ? state.area / elapsed : 0;
+
+#define PRINTER(printName, prefix, value) \
+  os << time << "\t" << m_node << "\t" << state.face << "\t" << printName << "\t" << prefix << "\t" << value << "\n";
+
+      if (state.queue != 0) {
+        PRINTER("AvgLength", "-", avgLength);
+        PRINTER("MaxLength", "-", state.max);
+        PRINTER("LengthP50", "-", state.length.Quantile(0.5));
+        PRINTER("LengthP99", "-", state.length.Quantile(0.99));
+        PRINTER("SojournP50Ms", "-", state.sojourn.Quantile(0.5) / 1000.0);
+        PRINTER("SojournP90Ms", "-", state.sojourn.Quantile(0.9) / 1000.0);
+        PRINTER("SojournP99Ms", "-", state.sojourn.Quantile(0.99) / 1000.0);
+        PRINTER("Enqueued", "-", state.enqueued);
+      }
+      for (const std::pair<const DropKey, uint64_t>& drop : state.drops) {
+        PRINTER(std::string("Drop-") + PacketClass::TypeName(drop.first.first), drop.first.second, drop.second);
+      }
+
+#undef PRINTER
+    }
+  }
+
+protected:
+  typedef std::pair<PacketClass::Type, std::string> DropKey;
+
+  struct DeviceState {
+    Ptr<Queue<Packet>> queue;
+    uint32_t skip = 0; // link header in front of the NDN block
+    std::size_t prefixDepth = 1;
+    std::string face;
+
+    LogHistogram length;       // packets, seen by each arrival
+    LogHistogram sojourn;      // microseconds
+    std::deque<int64_t> times; // enqueue time (ns) of the queued packets, FIFO
+    uint32_t current = 0;
+    uint32_t max = 0;
+    uint64_t enqueued = 0;
+    double area = 0; // packets x seconds since the period start
+    Time lastChange;
+    std::map<DropKey, uint64_t> drops;
+    PacketClass scratch;
+
+    void Advance(Time now) {
+      area += current * (now - lastChange).GetSeconds();
+      lastChange = now;
+    }
+
+    void Reset(Time now) {
+      length.Reset();
+      sojourn.Reset();
+      max = current;
+      enqueued = 0;
+      area = 0;
+      lastChange = now;
+      drops.clear();
+    }
+  };
+
+  static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<QueueTracer>>>>& Registry() {
+    static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<QueueTracer>>>> tracers;
+    return tracers;
+  }
+
+  static std::shared_ptr<std::ostream> OpenStream(const std::string& file) {
+    if (file == "-") {
+      return std::shared_ptr<std::ostream>(&std::cout, std::bind([] {}));
+    }
+
+    std::shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!os->is_open()) {
+      std::cerr << "File " << file << " cannot be opened for writing. Tracing disabled\n";
+      return nullptr;
+    }
+    return os;
+  }
+
+  static void Enqueue(DeviceState* state, Ptr<const Packet> packet) {
+    Time now = Simulator::Now();
+    state->length.Record(state->current);
+    state->Advance(now);
+    state->times.push_back(now.GetNanoSeconds());
+    state->current = state->queue->GetNPackets();
+    state->max = std::max(state->max, state->current);
+    state->enqueued++;
+  }
+
+  static void Dequeue(DeviceState* state, Ptr<const Packet> packet) {
+    Time now = Simulator::Now();
+    state->Advance(now);
+    if (!state->times.empty()) {
+      state->sojourn.Record((now.GetNanoSeconds() - state->times.front()) / 1000);
+      state->times.pop_front();
+    }
+    state->current = state->queue->GetNPackets();
+  }
+
+  static void Drop(DeviceState* state, Ptr<const Packet> packet) {
+    Classify(packet, state->skip, state->prefixDepth, state->scratch);
+    state->drops[DropKey(state->scratch.type, state->scratch.prefix)]++;
+  }
+
+  void Connect() {
+    std::map<uint32_t, std::string> faceByIfIndex;
+    Ptr<L3Protocol> l3 = m_nodePtr->GetObject<L3Protocol>();
+    if (l3 != 0) {
+      for (const Face& face : l3->getFaceTable()) {
+        NetDeviceTransport* transport = dynamic_cast<NetDeviceTransport*>(face.getTransport());
+        if (transport != nullptr) {
+          faceByIfIndex[transport->GetNetDevice()->GetIfIndex()] = std::to_string(face.getId());
+        }
+      }
+    }
+
+    for (uint32_t i = 0; i < m_nodePtr->GetNDevices(); i++) {
+      Ptr<NetDevice> device = m_nodePtr->GetDevice(i);
+      m_devices.emplace_back(new DeviceState());
+      DeviceState* state = m_devices.back().get();
+      state->prefixDepth = m_prefixDepth;
+      state->face = faceByIfIndex.count(i) ? faceByIfIndex[i] : "dev" + std::to_string(i);
+      state->skip = DynamicCast<PointToPointNetDevice>(device) != 0 ? 2 : 0; // PppHeader
+
+      PointerValue txQueue;
+      if (device->GetAttributeFailSafe("TxQueue", txQueue) && txQueue.Get<Queue<Packet>>() != 0) {
+        state->queue = txQueue.Get<Queue<Packet>>();
+        state->queue->TraceConnectWithoutContext("Enqueue", MakeBoundCallback(&QueueTracer::Enqueue, state));
+        state->queue->TraceConnectWithoutContext("Dequeue", MakeBoundCallback(&QueueTracer::Dequeue, state));
+        state->queue->TraceConnectWithoutContext("Drop", MakeBoundCallback(&QueueTracer::Drop, state));
+      }
+      else {
+        device->TraceConnectWithoutContext("Drop", MakeBoundCallback(&QueueTracer::Drop, state));
+      }
+    }
+  }
+
+  void SetAveragingPeriod(const Time& period) {
+    m_period = period;
+    m_printEvent.Cancel();
+    m_printEvent = Simulator::Schedule(m_period, &QueueTracer::PeriodicPrinter, this);
+    Reset();
+  }
+
+  void PeriodicPrinter() {
+    Print(*m_os);
+    Reset();
+    m_printEvent = Simulator::Schedule(m_period, &QueueTracer::PeriodicPrinter, this);
+  }
+
+  void Reset() {
+    m_periodStart = Simulator::Now();
+    for (const std::unique_ptr<DeviceState>& device : m_devices) {
+      device->Reset(m_periodStart);
+    }
+  }
+
+protected:
+  Ptr<Node> m_nodePtr;
+  std::string m_node;
+  std::shared_ptr<std::ostream> m_os;
+  std::size_t m_prefixDepth;
+
+  Time m_period;
+  Time m_periodStart;
+  EventId m_printEvent;
+
+  // the trace callbacks hold raw pointers to the states
+  std::vector<std::unique_ptr<DeviceState>> m_devices;
+};
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_QUEUE_TRACER_HPP
@@ -0,0 +1,253 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_SHM_METRICS_EXPORTER_HPP
+#define NDNSIM_SCRATCH_CUSTOM_SHM_METRICS_EXPORTER_HPP
+
+#include "ns3/callback.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/model/ndn-net-device-transport.hpp"
+
+#include "ndn-node-stats.hpp"
+#include "shm-metrics-layout.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief Publishes per-node and per-face counters into a POSIX shared-memory segment
+ *
+ * Every period one snapshot (CS, PIT, L3 face counters, L2 bytes and drops) is written
+ * into the next slot of the seqlock ring described in shm-metrics-layout.hpp. Nothing
+ * is formatted or written to disk; external tools (shm-metrics-reader.cc) attach to the
+ * segment by name and compute rates themselves.
+ *
+ * L2 counters come from the node's net devices: bytes from PhyTxEnd (packets actually
+ * sent; MacTx on devices without it, such as IdealNetDevice, whose MacTx only sees
+ * accepted packets) and drops from MacTxDrop, or Drop on devices without it. The TxQueue
+ * Drop source is not used: PointToPointNetDevice reports the same overflow as MacTxDrop.
+ *
+ * The segment is unlinked on Destroy; readers still attached keep the last snapshots.
+*/
+class ShmMetricsExporter : public SimpleRefCount<ShmMetricsExporter> {
+public:
+  static void Install(const std::string& name = "/ndnsim-metrics", Time period = Seconds(0.5),
+                      uint32_t slotCount = 8) {
+    Ptr<ShmMetricsExporter> exporter = Create<ShmMetricsExporter>(name, slotCount);
+    if (exporter->m_header == nullptr) {
+      return;
+    }
+    exporter->SetPeriod(period);
+    Registry().push_back(exporter);
+  }
+
+  /**
+   * \brief Explicit request to remove all exporters and their segments
+  */
+  static void Destroy() {
+    Registry().clear();
+  }
+
+  ShmMetricsExporter(const std::string& name, uint32_t slotCount)
+    : m_name(name)
+    , m_header(nullptr)
+    , m_size(0) {
+    uint32_t nodeCapacity = NodeList::GetNNodes();
+    uint32_t faceCapacity = stats::MAX_FACES;
+    m_size = shm::SegmentSize(nodeCapacity, faceCapacity, slotCount);
+
+    int fd = shm_open(m_name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, m_size) != 0) {
+      std::cerr << "Shared memory " << m_name << " cannot be created (" << std::strerror(errno)
+                << "). Export disabled\n";
+      if (fd >= 0) {
+        close(fd);
+        shm_unlink(m_name.c_str());
+      }
+      return;
+    }
+
+    void* addr = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+      std::cerr << "Shared memory " << m_name << " cannot be mapped (" << std::strerror(errno)
+                << "). Export disabled\n";
+      shm_unlink(m_name.c_str());
+      return;
+    }
+
+    // ftruncate zero-fills, so every slot seq and the published counter start at 0
+    m_header = static_cast<shm::ShmHeader*>(addr);
+    m_header->nodeCapacity = nodeCapacity;
+    m_header->faceCapacity = faceCapacity;
+    m_header->slotCount = slotCount;
+    m_header->slotSize = shm::SlotSize(nodeCapacity, faceCapacity);
+    m_header->version = shm::VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->magic = shm::MAGIC;
+
+    m_devices.resize(nodeCapacity);
+    for (uint32_t i = 0; i < nodeCapacity; i++) {
+      Ptr<Node> node = NodeList::GetNode(i);
+      m_devices[i].resize(node->GetNDevices());
+      for (uint32_t d = 0; d < node->GetNDevices(); d++) {
+        ConnectDevice(node->GetDevice(d), m_devices[i][d]);
+      }
+    }
+  }
+
+  ~ShmMetricsExporter() {
+    Simulator::Cancel(m_publishEvent);
+    if (m_header != nullptr) {
+      munmap(m_header, m_size);
+      shm_unlink(m_name.c_str());
+    }
+  }
+
+protected:
+  struct DeviceCounters {
+    uint64_t txBytes = 0;
+    uint64_t drops = 0;
+  };
+
+  static std::list<Ptr<ShmMetricsExporter>>& Registry() {
+    static std::list<Ptr<ShmMetricsExporter>> exporters;
+    return exporters;
+  }
+
+  static void CountTx(DeviceCounters* counters, Ptr<const Packet> packet) {
+    counters->txBytes += packet->GetSize();
+  }
+
+  static void CountDrop(DeviceCounters* counters, Ptr<const Packet> packet) {
+    counters->drops++;
+  }
+
+  /**
+   * \brief One source for bytes and one for drops per device, so nothing is counted twice
+  */
+  void ConnectDevice(Ptr<NetDevice> device, DeviceCounters& counters) {
+    // MacTx of PointToPointNetDevice fires before Enqueue, dropped packets included
+    if (!device->TraceConnectWithoutContext("PhyTxEnd",
+                                            MakeBoundCallback(&ShmMetricsExporter::CountTx, &counters))) {
+      device->TraceConnectWithoutContext("MacTx", MakeBoundCallback(&ShmMetricsExporter::CountTx, &counters));
+    }
+    if (!device->TraceConnectWithoutContext("MacTxDrop",
+                                            MakeBoundCallback(&ShmMetricsExporter::CountDrop, &counters))) {
+      device->TraceConnectWithoutContext("Drop", MakeBoundCallback(&ShmMetricsExporter::CountDrop, &counters));
+    }
+  }
+
+  void SetPeriod(const Time& period) {
+    m_period = period;
+    m_publishEvent.Cancel();
+    m_publishEvent = Simulator::Schedule(m_period, &ShmMetricsExporter::PeriodicPublish, this);
+  }
+
+  void PeriodicPublish() {
+    Publish();
+    m_publishEvent = Simulator::Schedule(m_period, &ShmMetricsExporter::PeriodicPublish, this);
+  }
+
+  void Publish() {
+    uint8_t* slot = shm::Slot(m_header, m_header->published.load(std::memory_order_relaxed));
+    shm::ShmSlotHeader* slotHeader = shm::SlotHeader(slot);
+    shm::ShmNodeRecord* nodes = shm::Nodes(slot);
+
+    shm::BeginWrite(slotHeader);
+    slotHeader->time = Simulator::Now().ToDouble(Time::S);
+    slotHeader->nNodes = 0;
+
+    for (uint32_t i = 0; i < m_header->nodeCapacity && i < NodeList::GetNNodes(); i++) {
+      Ptr<Node> node = NodeList::GetNode(i);
+      stats::Collect(node, m_scratch);
+
+      shm::ShmNodeRecord& record = nodes[slotHeader->nNodes++];
+      record.nodeId = m_scratch.nodeId;
+      record.nFaces = 0;
+      record.csSize = m_scratch.csSize;
+      record.csHits = m_scratch.csHits;
+      record.csMisses = m_scratch.csMisses;
+      record.pitSize = m_scratch.pitSize;
+      record.l2Drops = 0;
+      for (const DeviceCounters& device : m_devices[i]) {
+        record.l2Drops += device.drops;
+      }
+
+      shm::ShmFaceRecord* faces = shm::Faces(slot, m_header, i);
+      for (uint32_t f = 0; f < m_scratch.nFaceStats; f++) {
+        const stats::FaceStats& fs = m_scratch.faces[f];
+        shm::ShmFaceRecord& face = faces[record.nFaces++];
+        face.faceId = fs.faceId;
+        face.nInInterests = fs.nInInterests;
+        face.nOutInterests = fs.nOutInterests;
+        face.nInData = fs.nInData;
+        face.nOutData = fs.nOutData;
+        face.nInNacks = fs.nInNacks;
+        face.nOutNacks = fs.nOutNacks;
+        face.nInBytes = fs.nInBytes;
+        face.nOutBytes = fs.nOutBytes;
+        face.l2TxBytes = 0;
+        face.l2Drops = 0;
+
+        const DeviceCounters* device = FindDevice(node, i, fs.faceId);
+        if (device != nullptr) {
+          face.l2TxBytes = device->txBytes;
+          face.l2Drops = device->drops;
+        }
+      }
+    }
+
+    shm::EndWrite(m_header, slotHeader);
+  }
+
+  const DeviceCounters* FindDevice(Ptr<Node> node, uint32_t index, uint64_t faceId) const {
+    Face* face = node->GetObject<L3Protocol>()->getFaceTable().get(faceId);
+    if (face == nullptr) {
+      return nullptr;
+    }
+    NetDeviceTransport* transport = dynamic_cast<NetDeviceTransport*>(face->getTransport());
+    if (transport == nullptr) {
+      return nullptr;
+    }
+    uint32_t ifIndex = transport->GetNetDevice()->GetIfIndex();
+    return ifIndex < m_devices[index].size() ? &m_devices[index][ifIndex] : nullptr;
+  }
+
+protected:
+  std::string m_name;
+  shm::ShmHeader* m_header;
+  std::size_t m_size;
+
+  Time m_period;
+  EventId m_publishEvent;
+
+  // per node, per net device (ifIndex); sized once at install, never reallocated since
+  // the trace callbacks hold pointers into it
+  std::vector<std::vector<DeviceCounters>> m_devices;
+  stats::NodeStats m_scratch;
+};
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_SHM_METRICS_EXPORTER_HPP
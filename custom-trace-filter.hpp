@@ -0,0 +1,73 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_TRACE_FILTER_HPP
+#define NDNSIM_SCRATCH_CUSTOM_TRACE_FILTER_HPP
+
+#include "ns3/application.h"
+#include "ns3/ptr.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <cstdint>
+#include <functional>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief Name prefix + sampling rate restricting what a custom tracer records
+ *
+ * The node set is chosen by the NodeContainer given to Install, so nodes outside it get
+ * no hooks at all. The prefix is applied at install time wherever the traced object has
+ * a prefix of its own (an app's Prefix attribute); per-packet hooks only compare names
+ * when the filter is not a pass-all one.
+ *
+ * Sampling hashes the name (or another key), so a sampled interest is sampled on every
+ * node it crosses and per-hop records of the same request can still be joined.
+*/
+struct TraceFilter {
+  TraceFilter(const Name& prefix = Name("/"), double samplingRate = 1.0)
+    : prefix(prefix)
+    , samplingRate(samplingRate)
+    , threshold(samplingRate >= 1.0 ? UINT64_MAX : static_cast<uint64_t>(samplingRate * 18446744073709551615.0)) {
+  }
+
+  bool IsPassAll() const {
+    return prefix.empty() && samplingRate >= 1.0;
+  }
+
+  bool IsSampled(uint64_t key) const {
+    if (samplingRate >= 1.0) {
+      return true;
+    }
+    // splitmix64 finalizer so consecutive keys (sequence numbers) spread evenly
+    key += 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key < threshold;
+  }
+
+  bool Matches(const Name& name) const {
+    return prefix.isPrefixOf(name) && IsSampled(std::hash<Name>()(name));
+  }
+
+  /**
+   * \brief True if the app has a Prefix attribute under the filter prefix
+  */
+  bool MatchesApp(Ptr<Application> app) const {
+    if (prefix.empty()) {
+      return true;
+    }
+    NameValue appPrefix;
+    return app->GetAttributeFailSafe("Prefix", appPrefix) && prefix.isPrefixOf(appPrefix.Get());
+  }
+
+  Name prefix;
+  double samplingRate;
+  uint64_t threshold;
+};
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_TRACE_FILTER_HPP
@@ -0,0 +1,290 @@
+#ifndef NDNSIM_SCRATCH_CUSTOM_UNSATISFIED_TRACER_HPP
+#define NDNSIM_SCRATCH_CUSTOM_UNSATISFIED_TRACER_HPP
+
+#include "ns3/names.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/pointer.h"
+#include "ns3/ptr.h"
+#include "ns3/queue.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "custom-packet-classify.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace custom {
+
+/**
+ * \brief Root cause of every interest a node gave up on, counted per node and prefix
+ *
+ * Each unsatisfied PIT entry (beforeExpirePendingInterest, which also fires for entries
+ * rejected by the strategy) is put in exactly one class, as seen by that node:
+ *
+ * - NoRoute: never forwarded and the FIB has no next hop for it
+ * - Rejected: never forwarded although a route exists (strategy decision)
+ * - Nacked: forwarded, and every upstream answered with a Nack other than Duplicate
+ * - LinkDrop: forwarded, but the interest was dropped by this node's transmit queue
+ * - PitExpiry: forwarded and no answer before the lifetime ended
+ * - Loop: forwarded, every upstream answered with a Nack and one of them was Duplicate
+ *
+ * Duplicate Nacks the node sends itself are not counted: they do not end a PIT entry of
+ * this node, and the entry they answer shows up as Loop downstream. The node where a
+ * failure originates is the one with a non-Nacked class; nodes downstream of it see
+ * Nacked or PitExpiry. Data dropped on the way back shows up as PitExpiry downstream.
+ *
+ * Nothing runs for satisfied interests. The table is written once, when the simulator
+ * is destroyed:
+ *
+ *     Node Prefix NoRoute Rejected Nacked LinkDrop PitExpiry Loop
+*/
+class UnsatisfiedTracer : public SimpleRefCount<UnsatisfiedTracer> {
+public:
+  static void InstallAll(const std::string& file, std::size_t prefixDepth = 1) {
+    NodeContainer nodes;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      nodes.Add(*node);
+    }
+    Install(nodes, file, prefixDepth);
+  }
+
+  static void Install(const NodeContainer& nodes, const std::string& file, std::size_t prefixDepth = 1) {
+    std::list<Ptr<UnsatisfiedTracer>> tracers;
+    std::shared_ptr<std::ostream> outputStream = OpenStream(file);
+    if (outputStream == nullptr) {
+      return;
+    }
+
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+      if ((*node)->GetObject<L3Protocol>() == 0) {
+        continue;
+      }
+      tracers.push_back(Create<UnsatisfiedTracer>(outputStream, *node, prefixDepth));
+    }
+
+    if (Registry().empty()) {
+      Simulator::ScheduleDestroy(&UnsatisfiedTracer::PrintAll);
+    }
+    Registry().push_back(std::make_tuple(outputStream, tracers));
+  }
+
+  /**
+   * \brief Explicit request to remove all statically created tracers (without printing)
+  */
+  static void Destroy() {
+    Registry().clear();
+  }
+
+  UnsatisfiedTracer(std::shared_ptr<std::ostream> os, Ptr<Node> node, std::size_t prefixDepth = 1)
+    : m_nodePtr(node)
+    , m_os(os)
+    , m_prefixDepth(prefixDepth)
+    , m_purgeAt(1024) {
+    m_node = std::to_string(m_nodePtr->GetId());
+    std::string name = Names::FindName(node);
+    if (!name.empty()) {
+      m_node = name;
+    }
+    Connect();
+  }
+
+  void PrintHeader(std::ostream& os) const {
+    os << "Node" << "\t" << "Prefix" << "\t" << "NoRoute" << "\t" << "Rejected" << "\t" << "Nacked" << "\t"
+       << "LinkDrop" << "\t" << "PitExpiry" << "\t" << "Loop";
+  }
+
+  void Print(std::ostream& os) const {
+    for (const std::pair<const std::string, Counts>& prefix : m_counts) {
+      const Counts& c = prefix.second;
+      os << m_node << "\t" << prefix.first << "\t" << c.noRoute << "\t" << c.rejected << "\t" << c.nacked << "\t"
+         << c.linkDrop << "\t" << c.pitExpiry << "\t" << c.loop << "\n";
+    }
+  }
+
+protected:
+  struct Counts {
+    uint64_t noRoute = 0;
+    uint64_t rejected = 0;
+    uint64_t nacked = 0;
+    uint64_t linkDrop = 0;
+    uint64_t pitExpiry = 0;
+    uint64_t loop = 0;
+  };
+
+  struct DeviceHook {
+    UnsatisfiedTracer* tracer;
+    uint32_t skip;
+  };
+
+  static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<UnsatisfiedTracer>>>>& Registry() {
+    static std::list<std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<UnsatisfiedTracer>>>> tracers;
+    return tracers;
+  }
+
+  static std::shared_ptr<std::ostream> OpenStream(const std::string& file) {
+    if (file == "-") {
+      return std::shared_ptr<std::ostream>(&std::cout, std::bind([] {}));
+    }
+
+    std::shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!os->is_open()) {
+      std::cerr << "File " << file << " cannot be opened for writing. Tracing disabled\n";
+      return nullptr;
+    }
+    return os;
+  }
+
+  static void PrintAll() {
+    for (const std::tuple<std::shared_ptr<std::ostream>, std::list<Ptr<UnsatisfiedTracer>>>& entry : Registry()) {
+      std::ostream& os = *std::get<0>(entry);
+      const std::list<Ptr<UnsatisfiedTracer>>& tracers = std::get<1>(entry);
+      if (tracers.empty()) {
+        continue;
+      }
+      tracers.front()->PrintHeader(os);
+      os << "\n";
+      for (const Ptr<UnsatisfiedTracer>& tracer : tracers) {
+        tracer->Print(os);
+      }
+      os.flush();
+    }
+  }
+
+  static void QueueDrop(DeviceHook* hook, Ptr<const Packet> packet) {
+    hook->tracer->LinkDrop(packet, hook->skip);
+  }
+
+  void Connect() {
+    Ptr<L3Protocol> l3 = m_nodePtr->GetObject<L3Protocol>();
+    m_forwarder = l3->getForwarder();
+
+    m_expiredConn = m_forwarder->beforeExpirePendingInterest.connect(
+      [this](const nfd::pit::Entry& entry) { Unsatisfied(entry); });
+
+    m_hooks.resize(m_nodePtr->GetNDevices());
+    for (uint32_t i = 0; i < m_nodePtr->GetNDevices(); i++) {
+      Ptr<NetDevice> device = m_nodePtr->GetDevice(i);
+      m_hooks[i].tracer = this;
+      m_hooks[i].skip = DynamicCast<PointToPointNetDevice>(device) != 0 ? 2 : 0; // PppHeader
+
+      PointerValue txQueue;
+      if (device->GetAttributeFailSafe("TxQueue", txQueue) && txQueue.Get<Queue<Packet>>() != 0) {
+        txQueue.Get<Queue<Packet>>()->TraceConnectWithoutContext("Drop",
+          MakeBoundCallback(&UnsatisfiedTracer::QueueDrop, &m_hooks[i]));
+      }
+      else {
+        device->TraceConnectWithoutContext("Drop", MakeBoundCallback(&UnsatisfiedTracer::QueueDrop, &m_hooks[i]));
+      }
+    }
+  }
+
+  Counts& CountsFor(const Name& name) {
+    return m_counts[name.getPrefix(m_prefixDepth).toUri()];
+  }
+
+  void LinkDrop(Ptr<const Packet> packet, uint32_t skip) {
+    Classify(packet, skip, 0, m_scratch);
+    if (m_scratch.type != PacketClass::Interest || m_scratch.nameHash == 0) {
+      return;
+    }
+    m_dropped[m_scratch.nameHash] = Simulator::Now();
+
+    // interests dropped and then satisfied by a retransmission are never looked up again
+    if (m_dropped.size() >= m_purgeAt) {
+      Time horizon = Simulator::Now() - Seconds(10);
+      for (auto i = m_dropped.begin(); i != m_dropped.end();) {
+        i = i->second < horizon ? m_dropped.erase(i) : std::next(i);
+      }
+      m_purgeAt = std::max<std::size_t>(1024, 2 * m_dropped.size());
+    }
+  }
+
+  void Unsatisfied(const nfd::pit::Entry& entry) {
+    Counts& counts = CountsFor(entry.getName());
+
+    if (entry.getOutRecords().empty()) {
+      if (m_forwarder->getFib().findLongestPrefixMatch(entry).hasNextHops()) {
+        counts.rejected++;
+      }
+      else {
+        counts.noRoute++;
+      }
+      return;
+    }
+
+    if (!m_dropped.empty()) {
+      const Block& wire = entry.getName().wireEncode();
+      auto dropped = m_dropped.find(HashName(wire.value(), wire.value_size()));
+      if (dropped != m_dropped.end()) {
+        m_dropped.erase(dropped);
+        counts.linkDrop++;
+        return;
+      }
+    }
+
+    bool allNacked = true;
+    bool duplicate = false;
+    for (const nfd::pit::OutRecord& record : entry.getOutRecords()) {
+      const lp::NackHeader* nack = record.getIncomingNack();
+      if (nack == nullptr) {
+        allNacked = false;
+        break;
+      }
+      duplicate = duplicate || nack->getReason() == lp::NackReason::DUPLICATE;
+    }
+
+    if (!allNacked) {
+      counts.pitExpiry++;
+    }
+    else if (duplicate) {
+      counts.loop++;
+    }
+    else {
+      counts.nacked++;
+    }
+  }
+
+protected:
+  Ptr<Node> m_nodePtr;
+  std::string m_node;
+  std::shared_ptr<std::ostream> m_os;
+  std::size_t m_prefixDepth;
+  std::shared_ptr<nfd::Forwarder> m_forwarder;
+
+  ::ndn::util::signal::ScopedConnection m_expiredConn;
+
+  std::vector<DeviceHook> m_hooks; // sized once, the drop callbacks point into it
+  PacketClass m_scratch;
+  std::unordered_map<uint64_t, Time> m_dropped; // name hash of dropped interests -> drop time
+  std::size_t m_purgeAt;
+
+  std::map<std::string, Counts> m_counts;
+};
+
+} // namespace custom
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_CUSTOM_UNSATISFIED_TRACER_HPP
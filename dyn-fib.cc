@@ -22,6 +22,15 @@
 #include "ns3/ndnSIM/utils/tracers/ndn-app-delay-tracer.hpp"
 #include "ns3/ndnSIM/utils/tracers/l2-rate-tracer.hpp"
 
+#include "fast-topology-reader.hpp"
+#include "ndn-consumer-trace-replay.hpp"
+#include "custom-unsatisfied-tracer.hpp"
+#include "ndn-cache-placement.hpp"
+#include "ndn-link-state-routing.hpp"
+#include "ndn-failure-helper.hpp"
+#include "ndn-lfa-routing-helper.hpp"
+#include "ndn-adaptive-multipath-strategy.hpp"
+
 #include <memory>
 #include <iostream>
 #include <vector>
@@ -53,13 +62,34 @@ void PrintAllNodeInfo() {
 }
 
 int main(int argc, char* argv[]) {
+  std::string requestTrace; // <time> <node> <name> records replacing the cbr consumers
+  bool unsatisfied = false;
+  std::string placement; // cache placement on intermediate nodes, empty for plain lru
+  bool linkState = false; // in-band link state routing instead of precomputed global routes
+  std::string failLink;   // "<a>-<b>", 1-based node numbers like the indexes below
+  double failAt = 20, restoreAt = 30;
+  bool lfa = false;       // single best routes plus loop-free alternates
+  std::string strategy = "/localhost/nfd/strategy/best-route";
+
   ns3::CommandLine cmd;
+  cmd.AddValue("requestTrace", "request trace replayed by the consumer nodes", requestTrace);
+  cmd.AddValue("unsatisfied", "write per node/prefix causes of unsatisfied interests at the end", unsatisfied);
+  cmd.AddValue("placement", "cache placement on intermediate nodes: lce, lcd, probcache or betweenness", placement);
+  cmd.AddValue("linkState", "compute routes with the in-band link state protocol instead of GlobalRoutingHelper",
+    linkState);
+  cmd.AddValue("failLink", "link <a>-<b> (1-based node numbers) taken down at failAt and up at restoreAt", failLink);
+  cmd.AddValue("failAt", "time the failed link goes down (s)", failAt);
+  cmd.AddValue("restoreAt", "time the failed link comes back up (s), 0 for never", restoreAt);
+  cmd.AddValue("lfa", "install best routes only and switch to loop-free alternates on failure", lfa);
+  cmd.AddValue("strategy", "forwarding strategy of the prefixes, e.g. /localhost/nfd/strategy/adaptive-multipath",
+    strategy);
   // cmd.PrintHelp(std::cout);
   cmd.Parse(argc, argv);
 
   std::string topoFile = "scratch/dyn-fib-topology.txt";
 
-  ns3::AnnotatedTopologyReader topoReader("", 40);
+  // same file format as AnnotatedTopologyReader, mmap'ed and parsed in parallel
+  ns3::FastTopologyReader topoReader("", 40);
   topoReader.SetFileName(topoFile);
   topoReader.Read();
 
@@ -110,15 +140,21 @@ int main(int argc, char* argv[]) {
   ns3::ndn::GlobalRoutingHelper routingHelper;
   routingHelper.InstallAll();
 
+  if (!placement.empty()) {
+    ns3::ndn::CachePlacementHelper placementHelper;
+    placementHelper.SetMode(placement);
+    placementHelper.Install(intCont);
+  }
+
   routingHelper.AddOrigin("prefix-3", nodes.Get(18 - 1));
   routingHelper.AddOrigin("prefix-2", nodes.Get(19 - 1));
   routingHelper.AddOrigin("prefix-1", nodes.Get(21 - 1));
   routingHelper.AddOrigin("prefix-1", nodes.Get(22 - 1));
   routingHelper.AddOrigin("prefix-2", nodes.Get(23 - 1));
 
-  ns3::ndn::StrategyChoiceHelper::InstallAll("prefix-1", "/localhost/nfd/strategy/best-route");
-  ns3::ndn::StrategyChoiceHelper::InstallAll("prefix-2", "/localhost/nfd/strategy/best-route");
-  ns3::ndn::StrategyChoiceHelper::InstallAll("prefix-3", "/localhost/nfd/strategy/best-route");
+  ns3::ndn::StrategyChoiceHelper::InstallAll("prefix-1", strategy);
+  ns3::ndn::StrategyChoiceHelper::InstallAll("prefix-2", strategy);
+  ns3::ndn::StrategyChoiceHelper::InstallAll("prefix-3", strategy);
 
   ns3::ndn::AppHelper consHelper("ns3::ndn::ConsumerCbr"), prodHelper("ns3::ndn::Producer");
 
@@ -159,12 +195,21 @@ int main(int argc, char* argv[]) {
 
   consHelper.SetPrefix("prefix-1");
 
-  for (const std::tuple<int, int, int>& pr : consumerAppNodeTime) {
-    int nodeId = std::get<0>(pr) - 1, s = std::get<1>(pr), e = std::get<2>(pr);
-    ns3::ApplicationContainer appCont = consHelper.Install(ns3::NodeList::GetNode(0));
-    // can use application container directly becoz we have installed only one app in each node
-    // to set start time and end time
-    // appCont.Start(ns3::Seconds(s)), appCont.Stop(ns3::Seconds(e));
+  if (!requestTrace.empty()) {
+    // one shared reader streams the trace for all consumer nodes
+    ns3::ndn::AppHelper replayHelper("ns3::ndn::ConsumerTraceReplay");
+    replayHelper.SetAttribute("TraceFile", ns3::StringValue(requestTrace));
+    replayHelper.SetAttribute("LifeTime", ns3::TimeValue(ns3::Seconds(1)));
+    replayHelper.Install(consCont);
+  }
+  else {
+    for (const std::tuple<int, int, int>& pr : consumerAppNodeTime) {
+      int nodeId = std::get<0>(pr) - 1, s = std::get<1>(pr), e = std::get<2>(pr);
+      ns3::ApplicationContainer appCont = consHelper.Install(ns3::NodeList::GetNode(0));
+      // can use application container directly becoz we have installed only one app in each node
+      // to set start time and end time
+      // appCont.Start(ns3::Seconds(s)), appCont.Stop(ns3::Seconds(e));
+    }
   }
 
   // consHelper.SetPrefix("prefix-3");
@@ -215,7 +260,42 @@ int main(int argc, char* argv[]) {
   // (*lastApp)->SetStartTime(ns3::Seconds(31));
   // (*lastApp)->SetStopTime(ns3::Seconds(45));
 
-  routingHelper.CalculateAllPossibleRoutes();
+  if (linkState) {
+    // producers announce their prefixes while they run
+    ns3::ndn::LinkStateRoutingHelper lsrHelper;
+    lsrHelper.InstallAll();
+    lsrHelper.AnnounceProducers(prodCont);
+  }
+  else if (lfa) {
+    routingHelper.CalculateRoutes();
+    ns3::ndn::LfaRoutingHelper::CalculateBackups();
+  }
+  else {
+    routingHelper.CalculateAllPossibleRoutes();
+  }
+
+  if (!failLink.empty()) {
+    std::size_t dash = failLink.find('-');
+    int a = std::atoi(failLink.substr(0, dash).c_str()), b = std::atoi(failLink.substr(dash + 1).c_str());
+    if (dash == std::string::npos || a < 1 || b < 1 || a > (int)nodes.GetN() || b > (int)nodes.GetN()) {
+      std::cerr << "failLink expects <a>-<b> with 1 <= a, b <= " << nodes.GetN() << "\n";
+      return 1;
+    }
+    ns3::ndn::FailureHelper::ScheduleLinkFailure(nodes.Get(a - 1), nodes.Get(b - 1), ns3::Seconds(failAt),
+      ns3::Seconds(restoreAt));
+    ns3::ndn::FailureHelper::TrackConsumers(consCont);
+
+    if (linkState) {
+      ns3::ndn::FailureHelper::AddLinkCallback([](ns3::Ptr<ns3::Node> node, ns3::ndn::nfd::FaceId,
+                                                  ns3::Ptr<ns3::Node> peer, bool up) {
+        ns3::ndn::LinkStateRouter::Find(node)->SetLinkUp(peer->GetId(), up);
+      });
+    }
+  }
+
+  if (unsatisfied) {
+    ns3::ndn::custom::UnsatisfiedTracer::InstallAll("./scratch/dyn-fib-unsatisfied.txt");
+  }
 
   // ns3::ndn::L3RateTracer::InstallAll("./scratch/dyn-fib-l3ratetrace.txt");
   // ns3::ndn::CsTracer::InstallAll("./scratch/dyn-fib-cstrace.txt",ns3::Seconds(2));
@@ -226,5 +306,22 @@ int main(int argc, char* argv[]) {
 
   ns3::Simulator::Stop(ns3::Seconds(50));
   ns3::Simulator::Run();
+  if (!placement.empty()) {
+    ns3::ndn::CachePlacementHelper::PrintStats(std::cout);
+    std::cout << "Rejected inserts: " << ns3::ndn::CachePlacementHelper::GetRejected() << "\n";
+  }
+  if (linkState) {
+    ns3::ndn::LinkStateRoutingHelper::PrintStats(std::cout);
+  }
+  if (lfa) {
+    ns3::ndn::LfaRoutingHelper::PrintStats(std::cout);
+  }
+  if (strategy.find("adaptive-multipath") != std::string::npos) {
+    nfd::fw::AdaptiveMultipathStrategy::PrintStats(std::cout);
+  }
+  if (!failLink.empty()) {
+    ns3::ndn::FailureHelper::PrintRecovery(std::cout);
+    ns3::ndn::FailureHelper::Destroy();
+  }
   ns3::Simulator::Destroy();
 }
@@ -0,0 +1,441 @@
+#ifndef NDNSIM_SCRATCH_FAST_TOPOLOGY_READER_HPP
+#define NDNSIM_SCRATCH_FAST_TOPOLOGY_READER_HPP
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/names.h"
+#include "ns3/error-model.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/ndnSIM/utils/topology/annotated-topology-reader.hpp"
+
+#include "ideal-link.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <initializer_list>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+/**
+ * \brief Reader for annotated topology files with tens of thousands of links
+ *
+ * Same format, node order, names and link attributes as AnnotatedTopologyReader, but:
+ *
+ * 1. the file is mmap'ed and tokenized in place (no iostreams, no per-line strings)
+ * 2. the link section is split at line boundaries and tokenized by several threads
+ * 3. node names are resolved through a local hash map instead of Names::Find
+ *
+ * ns-3 objects (nodes, devices, channels) are not thread safe, so the devices are
+ * still created on the simulation thread, in batches, after all lines are parsed;
+ * the helper attributes are only touched when a link differs from the previous one.
+ *
+ * Every malformed line is reported as file:line and the read is aborted afterwards;
+ * capacity, metric, delay, queue size and loss rate are checked while tokenizing, so a
+ * bad value is reported with its line instead of failing later in an attribute setter.
+ * LossRate installs a packet RateErrorModel on both devices, like AnnotatedTopologyReader
+ * (ideal links have no error model, there it is only kept as a link attribute).
+*/
+class FastTopologyReader : public AnnotatedTopologyReader {
+public:
+  FastTopologyReader(const std::string& path = "", double scale = 1.0)
+    : AnnotatedTopologyReader(path, scale)
+    , m_scale(scale)
+    , m_idealLinks(false)
+    , m_threads(std::max(1u, std::thread::hardware_concurrency())) {
+  }
+
+  /**
+   * \brief Create IdealLinkHelper links instead of PointToPoint ones
+  */
+  void SetIdealLinks(bool idealLinks) {
+    m_idealLinks = idealLinks;
+  }
+
+  void SetParseThreads(unsigned threads) {
+    m_threads = std::max(1u, threads);
+  }
+
+  NodeContainer Read() override {
+    MappedFile file(GetFileName());
+    std::string_view text(file.data, file.size);
+
+    Cursor cursor{ text, 0, 0 };
+    std::string_view line;
+
+    while (cursor.Next(line) && line != "router") {
+    }
+    if (cursor.pos >= text.size()) {
+      NS_FATAL_ERROR("Topology file " << GetFileName() << " does not have \"router\" section");
+    }
+
+    ReadRouters(cursor);
+    if (cursor.pos >= text.size()) {
+      NS_FATAL_ERROR("Topology file " << GetFileName() << " does not have \"link\" section");
+    }
+
+    std::vector<LinkRecord> links = ParseLinks(text.substr(cursor.pos), cursor.line);
+    CreateLinks(links);
+
+    if (!m_errors.empty()) {
+      for (const std::string& error : m_errors) {
+        std::cerr << error << "\n";
+      }
+      NS_FATAL_ERROR(m_errors.size() << " malformed line(s) in " << GetFileName());
+    }
+
+    return m_nodes;
+  }
+
+private:
+  typedef std::vector<std::string_view> Tokens;
+
+  struct MappedFile {
+    explicit MappedFile(const std::string& name) : data(nullptr), size(0) {
+      int fd = ::open(name.c_str(), O_RDONLY);
+      struct stat st;
+      if (fd < 0 || ::fstat(fd, &st) != 0) {
+        NS_FATAL_ERROR("Cannot open file " << name << " for reading");
+      }
+      size = st.st_size;
+      if (size > 0) {
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+          NS_FATAL_ERROR("Cannot map file " << name);
+        }
+        ::madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+      }
+      ::close(fd);
+    }
+
+    ~MappedFile() {
+      if (data != nullptr) {
+        ::munmap(const_cast<char*>(data), size);
+      }
+    }
+
+    const char* data;
+    size_t size;
+  };
+
+  struct Cursor {
+    std::string_view text;
+    size_t pos;
+    size_t line; // number of the line last returned by Next
+
+    bool Next(std::string_view& out) {
+      if (pos >= text.size()) {
+        return false;
+      }
+      size_t end = text.find('\n', pos);
+      if (end == std::string_view::npos) {
+        end = text.size();
+      }
+      out = text.substr(pos, end - pos);
+      if (!out.empty() && out.back() == '\r') {
+        out.remove_suffix(1);
+      }
+      pos = end + 1;
+      line++;
+      return true;
+    }
+  };
+
+  struct LinkRecord {
+    size_t line;
+    std::string_view from, to, capacity, metric, delay, maxPackets, lossRate;
+  };
+
+  struct Malformed {
+    size_t line; // chunk-relative until merged
+    std::string message;
+  };
+
+  static void Split(std::string_view line, Tokens& tokens) {
+    tokens.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+      while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) {
+        i++;
+      }
+      size_t start = i;
+      while (i < line.size() && line[i] != ' ' && line[i] != '\t') {
+        i++;
+      }
+      if (i > start) {
+        tokens.push_back(line.substr(start, i - start));
+      }
+    }
+  }
+
+  static bool ToDouble(std::string_view token, double& value) {
+    char buffer[64];
+    if (token.size() >= sizeof(buffer)) {
+      return false;
+    }
+    std::memcpy(buffer, token.data(), token.size());
+    buffer[token.size()] = '\0';
+    char* end = nullptr;
+    value = std::strtod(buffer, &end);
+    return end == buffer + token.size();
+  }
+
+  /**
+   * \brief Number followed by one of the units (or none, when bare is allowed)
+  */
+  static bool HasUnit(std::string_view token, std::initializer_list<std::string_view> units) {
+    size_t digits = 0;
+    while (digits < token.size() && (std::isdigit(static_cast<unsigned char>(token[digits])) || token[digits] == '.'
+                                     || token[digits] == 'e' || token[digits] == '-' || token[digits] == '+')) {
+      digits++;
+    }
+    double value = 0;
+    if (digits == 0 || !ToDouble(token.substr(0, digits), value) || value < 0) {
+      return false;
+    }
+    std::string_view unit = token.substr(digits);
+    return unit.empty() || std::find(units.begin(), units.end(), unit) != units.end();
+  }
+
+  /**
+   * \returns what is wrong with the link fields, empty if nothing
+  */
+  static std::string Check(const LinkRecord& record) {
+    double value = 0;
+    if (!HasUnit(record.capacity, { "bps", "b/s", "Bps", "B/s", "kbps", "kb/s", "Kbps", "Kb/s", "kBps", "kB/s",
+                                    "KBps", "KB/s", "Kib/s", "KiB/s", "Mbps", "Mb/s", "MBps", "MB/s", "Mib/s",
+                                    "MiB/s", "Gbps", "Gb/s", "GBps", "GB/s", "Gib/s", "GiB/s" })) {
+      return "bad capacity \"" + std::string(record.capacity) + "\"";
+    }
+    if (!record.metric.empty() && !ToDouble(record.metric, value)) {
+      return "bad metric \"" + std::string(record.metric) + "\"";
+    }
+    if (!record.delay.empty()
+        && !HasUnit(record.delay, { "s", "ms", "us", "ns", "ps", "fs", "min", "h", "d", "y" })) {
+      return "bad delay \"" + std::string(record.delay) + "\"";
+    }
+    if (!record.maxPackets.empty()
+        && (!ToDouble(record.maxPackets, value) || value < 0 || value != std::floor(value))) {
+      return "bad queue size \"" + std::string(record.maxPackets) + "\"";
+    }
+    if (!record.lossRate.empty() && (!ToDouble(record.lossRate, value) || value < 0 || value > 1)) {
+      return "bad loss rate \"" + std::string(record.lossRate) + "\" (expected 0..1)";
+    }
+    return std::string();
+  }
+
+  void Error(size_t line, const std::string& message) {
+    m_errors.push_back(GetFileName() + ":" + std::to_string(line) + ": " + message);
+  }
+
+  void ReadRouters(Cursor& cursor) {
+    Ptr<UniformRandomVariable> var = CreateObject<UniformRandomVariable>();
+    Tokens tokens;
+    std::string_view line;
+
+    while (cursor.Next(line) && line != "link") {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+      Split(line, tokens);
+      if (tokens.empty()) {
+        continue;
+      }
+
+      double latitude = 0, longitude = 0;
+      uint32_t systemId = 0;
+      if ((tokens.size() > 2 && !ToDouble(tokens[2], latitude))
+          || (tokens.size() > 3 && !ToDouble(tokens[3], longitude))) {
+        Error(cursor.line, "bad coordinates for router " + std::string(tokens[0]));
+        continue;
+      }
+      if (tokens.size() > 4) {
+        double id = 0;
+        if (!ToDouble(tokens[4], id) || id < 0) {
+          Error(cursor.line, "bad system id for router " + std::string(tokens[0]));
+          continue;
+        }
+        systemId = static_cast<uint32_t>(id);
+      }
+
+      std::string name(tokens[0]);
+      Ptr<Node> node;
+      if (std::abs(latitude) > 0.001 && std::abs(longitude) > 0.001) {
+        node = CreateNode(name, m_scale * longitude, -m_scale * latitude, systemId);
+      }
+      else {
+        node = CreateNode(name, var->GetValue(0, 200), var->GetValue(0, 200), systemId);
+      }
+      m_nodeByName.emplace(name, node);
+    }
+  }
+
+  /**
+   * \brief Tokenize the link section with m_threads threads
+   * \param firstLine number of the line preceding the section
+  */
+  std::vector<LinkRecord> ParseLinks(std::string_view section, size_t firstLine) {
+    // chunk boundaries at line starts
+    std::vector<size_t> bounds{ 0 };
+    size_t step = section.size() / m_threads + 1;
+    for (unsigned i = 1; i < m_threads; i++) {
+      size_t pos = section.find('\n', std::max(bounds.back(), i * step));
+      if (pos == std::string_view::npos) {
+        break;
+      }
+      bounds.push_back(pos + 1);
+    }
+    bounds.push_back(section.size());
+
+    size_t nChunks = bounds.size() - 1;
+    std::vector<std::vector<LinkRecord>> records(nChunks);
+    std::vector<std::vector<Malformed>> malformed(nChunks);
+    std::vector<size_t> lineCounts(nChunks, 0);
+    std::vector<std::thread> workers;
+
+    for (size_t c = 0; c < nChunks; c++) {
+      workers.emplace_back([&, c] {
+        Cursor cursor{ section.substr(bounds[c], bounds[c + 1] - bounds[c]), 0, 0 };
+        Tokens tokens;
+        std::string_view line;
+        while (cursor.Next(line)) {
+          if (line.empty() || line[0] == '#') {
+            continue;
+          }
+          Split(line, tokens);
+          if (tokens.empty()) {
+            continue;
+          }
+          if (tokens.size() < 3) {
+            malformed[c].push_back(Malformed{ cursor.line, "link needs at least <from> <to> <capacity>" });
+            continue;
+          }
+          tokens.resize(std::max<size_t>(tokens.size(), 7));
+          LinkRecord record{ cursor.line, tokens[0], tokens[1], tokens[2], tokens[3], tokens[4], tokens[5],
+                             tokens[6] };
+          std::string problem = Check(record);
+          if (!problem.empty()) {
+            malformed[c].push_back(Malformed{ cursor.line, problem });
+            continue;
+          }
+          records[c].push_back(record);
+        }
+        lineCounts[c] = cursor.line;
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+
+    std::vector<LinkRecord> links;
+    size_t offset = firstLine;
+    for (size_t c = 0; c < nChunks; c++) {
+      for (const Malformed& error : malformed[c]) {
+        Error(offset + error.line, error.message);
+      }
+      for (LinkRecord& record : records[c]) {
+        record.line += offset;
+        links.push_back(record);
+      }
+      offset += lineCounts[c];
+    }
+    return links;
+  }
+
+  Ptr<Node> FindNode(std::string_view name) const {
+    auto it = m_nodeByName.find(std::string(name));
+    return it == m_nodeByName.end() ? nullptr : it->second;
+  }
+
+  void CreateLinks(const std::vector<LinkRecord>& links) {
+    PointToPointHelper p2p;
+    IdealLinkHelper ideal;
+    LinkRecord previous{ 0 };
+
+    std::unordered_set<std::string> processed; // "to\nfrom" of links already created
+
+    for (const LinkRecord& record : links) {
+      std::string key = std::string(record.from) + '\n' + std::string(record.to);
+      std::string reverse = std::string(record.to) + '\n' + std::string(record.from);
+      if (processed.count(reverse) != 0) {
+        continue; // duplicated link
+      }
+      processed.insert(std::move(key));
+
+      Ptr<Node> fromNode = FindNode(record.from);
+      Ptr<Node> toNode = FindNode(record.to);
+      if (fromNode == nullptr || toNode == nullptr) {
+        Error(record.line, std::string(fromNode == nullptr ? record.from : record.to) + " node not found");
+        continue;
+      }
+
+      if (record.capacity != previous.capacity) {
+        p2p.SetDeviceAttribute("DataRate", StringValue(std::string(record.capacity)));
+        ideal.SetDeviceAttribute("DataRate", StringValue(std::string(record.capacity)));
+      }
+      if (!record.delay.empty() && record.delay != previous.delay) {
+        p2p.SetChannelAttribute("Delay", StringValue(std::string(record.delay)));
+        ideal.SetChannelAttribute("Delay", StringValue(std::string(record.delay)));
+      }
+      if (!record.maxPackets.empty() && record.maxPackets != previous.maxPackets) {
+        p2p.SetQueue("ns3::DropTailQueue<Packet>", "MaxSize", StringValue(std::string(record.maxPackets) + "p"));
+        ideal.SetDeviceAttribute("MaxPackets", StringValue(std::string(record.maxPackets)));
+      }
+      previous = record;
+
+      Link link(fromNode, std::string(record.from), toNode, std::string(record.to));
+      link.SetAttribute("DataRate", std::string(record.capacity));
+      link.SetAttribute("OSPF", std::string(record.metric));
+      if (!record.delay.empty()) {
+        link.SetAttribute("Delay", std::string(record.delay));
+      }
+      if (!record.maxPackets.empty()) {
+        link.SetAttribute("MaxPackets", std::string(record.maxPackets));
+      }
+      if (!record.lossRate.empty()) {
+        link.SetAttribute("LossRate", std::string(record.lossRate));
+      }
+
+      NetDeviceContainer nd = m_idealLinks ? ideal.Install(fromNode, toNode) : p2p.Install(fromNode, toNode);
+      if (!record.lossRate.empty()) {
+        for (uint32_t i = 0; i < nd.GetN(); i++) {
+          Ptr<RateErrorModel> errors = CreateObject<RateErrorModel>();
+          errors->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+          errors->SetRate(std::strtod(std::string(record.lossRate).c_str(), nullptr));
+          nd.Get(i)->SetAttributeFailSafe("ReceiveErrorModel", PointerValue(errors));
+        }
+      }
+      link.SetNetDevices(nd.Get(0), nd.Get(1));
+      AddLink(link);
+    }
+  }
+
+private:
+  double m_scale;
+  bool m_idealLinks;
+  unsigned m_threads;
+  std::unordered_map<std::string, Ptr<Node>> m_nodeByName;
+  std::vector<std::string> m_errors;
+};
+
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_FAST_TOPOLOGY_READER_HPP
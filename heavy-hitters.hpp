@@ -0,0 +1,175 @@
+#ifndef NDNSIM_SCRATCH_HEAVY_HITTERS_HPP
+#define NDNSIM_SCRATCH_HEAVY_HITTERS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \brief Fixed-memory top-K of a stream of keys: count-min sketch plus a K entry table
+ *
+ * Every key is given as a 64-bit hash; its frequency is estimated by a count-min sketch
+ * of depth rows and width counters (conservative update, so an estimate exceeds the
+ * true count by at most ~e/width of the total with probability 1 - e^-depth). The K keys
+ * with the largest estimates are kept with their name; the name is only produced (by
+ * the callable given to Add) when a key enters the table, so the steady-state cost is
+ * depth counter updates and one lookup per key.
+ *
+ * Memory is depth * width * 4 bytes plus K entries whatever the number of distinct keys.
+*/
+class HeavyHitters {
+public:
+  struct Item {
+    uint64_t hash;
+    uint64_t count; // estimate
+    std::string name;
+  };
+
+  static constexpr uint32_t MAX_DEPTH = 16;
+
+  /**
+   * \param width rounded up to a power of two
+  */
+  explicit HeavyHitters(uint32_t k = 10, uint32_t width = 1024, uint32_t depth = 4)
+    : m_k(std::max<uint32_t>(k, 1))
+    , m_depth(std::min(std::max<uint32_t>(depth, 1), MAX_DEPTH))
+    , m_min(0)
+    , m_total(0) {
+    m_width = 1;
+    while (m_width < width) {
+      m_width <<= 1;
+    }
+    m_counters.assign(static_cast<std::size_t>(m_width) * m_depth, 0);
+    m_top.reserve(m_k);
+    m_index.reserve(m_k);
+  }
+
+  void Reset() {
+    std::fill(m_counters.begin(), m_counters.end(), 0);
+    m_top.clear();
+    m_index.clear();
+    m_min = 0;
+    m_total = 0;
+  }
+
+  /**
+   * \brief Count one occurrence of the key; name() returns its std::string name
+  */
+  template<typename NameFn>
+  void Add(uint64_t hash, NameFn&& name, uint32_t weight = 1) {
+    m_total += weight;
+    uint64_t estimate = Update(hash, weight);
+
+    auto known = m_index.find(hash);
+    if (known != m_index.end()) {
+      m_top[known->second].count = estimate;
+      return;
+    }
+    if (m_top.size() < m_k) {
+      m_index.emplace(hash, static_cast<uint32_t>(m_top.size()));
+      m_top.push_back(Item{ hash, estimate, name() });
+      m_min = m_top.size() == m_k ? MinCount() : 0;
+      return;
+    }
+    // m_min is a lower bound of the smallest count in the table (counts only grow)
+    if (estimate <= m_min) {
+      return;
+    }
+    uint32_t smallest = MinSlot();
+    m_min = m_top[smallest].count;
+    if (estimate <= m_min) {
+      return;
+    }
+    Item& item = m_top[smallest];
+    m_index.erase(item.hash);
+    m_index.emplace(hash, smallest);
+    item.hash = hash;
+    item.count = estimate;
+    item.name = name();
+    m_min = MinCount();
+  }
+
+  uint64_t Estimate(uint64_t hash) const {
+    uint64_t estimate = UINT64_MAX;
+    for (uint32_t row = 0; row < m_depth; row++) {
+      estimate = std::min<uint64_t>(estimate, m_counters[Cell(hash, row)]);
+    }
+    return estimate;
+  }
+
+  /**
+   * \brief Kept keys, largest estimate first
+  */
+  std::vector<Item> Top() const {
+    std::vector<Item> top = m_top;
+    std::sort(top.begin(), top.end(), [](const Item& a, const Item& b) { return a.count > b.count; });
+    return top;
+  }
+
+  /**
+   * \brief Sum of the weights added since the last Reset
+  */
+  uint64_t Total() const {
+    return m_total;
+  }
+
+private:
+  static uint64_t Mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  std::size_t Cell(uint64_t hash, uint32_t row) const {
+    return static_cast<std::size_t>(row) * m_width + (Mix(hash + row * 0x9e3779b97f4a7c15ULL) & (m_width - 1));
+  }
+
+  /**
+   * \brief Conservative update: only the counters at the current minimum are raised
+  */
+  uint64_t Update(uint64_t hash, uint32_t weight) {
+    std::size_t cells[MAX_DEPTH];
+    uint64_t estimate = UINT64_MAX;
+    for (uint32_t row = 0; row < m_depth; row++) {
+      cells[row] = Cell(hash, row);
+      estimate = std::min<uint64_t>(estimate, m_counters[cells[row]]);
+    }
+    estimate = std::min<uint64_t>(estimate + weight, UINT32_MAX);
+    for (uint32_t row = 0; row < m_depth; row++) {
+      m_counters[cells[row]] = std::max<uint32_t>(m_counters[cells[row]], static_cast<uint32_t>(estimate));
+    }
+    return estimate;
+  }
+
+  uint32_t MinSlot() const {
+    uint32_t smallest = 0;
+    for (uint32_t i = 1; i < m_top.size(); i++) {
+      if (m_top[i].count < m_top[smallest].count) {
+        smallest = i;
+      }
+    }
+    return smallest;
+  }
+
+  uint64_t MinCount() const {
+    return m_top.empty() ? 0 : m_top[MinSlot()].count;
+  }
+
+private:
+  uint32_t m_k;
+  uint32_t m_width;
+  uint32_t m_depth;
+  std::vector<uint32_t> m_counters; // m_depth rows of m_width
+  std::vector<Item> m_top;
+  std::unordered_map<uint64_t, uint32_t> m_index; // hash -> slot in m_top
+  uint64_t m_min;
+  uint64_t m_total;
+};
+
+#endif // NDNSIM_SCRATCH_HEAVY_HITTERS_HPP
@@ -0,0 +1,428 @@
+#ifndef NDNSIM_SCRATCH_IDEAL_LINK_HPP
+#define NDNSIM_SCRATCH_IDEAL_LINK_HPP
+
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/names.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/data-rate.h"
+#include "ns3/mac48-address.h"
+#include "ns3/object-factory.h"
+#include "ns3/traced-callback.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ndnSIM/utils/topology/annotated-topology-reader.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <set>
+#include <string>
+
+/**
+ * \brief Analytic point-to-point link for large NDN runs.
+ *
+ * PointToPointNetDevice + DropTailQueue schedules a transmit-complete event per packet
+ * per hop plus a receive event on the channel. The ideal link keeps only the time the
+ * transmitter becomes free: the arrival time of a packet is computed once when it is
+ * sent and a single delivery event is scheduled on the peer node.
+ *
+ * Serialization delay uses the same framing overhead as PointToPoint (2 byte PPP
+ * header), so per-hop timing matches p2p as long as the backlog limit is not reached.
+*/
+
+namespace ns3 {
+
+class IdealNetDevice;
+
+/**
+ * \brief Channel that connects exactly two IdealNetDevice objects
+*/
+class IdealChannel : public Channel {
+public:
+  static TypeId GetTypeId() {
+    static TypeId tid = TypeId("ns3::IdealChannel")
+      .SetParent<Channel>()
+      .SetGroupName("Ndn")
+      .AddConstructor<IdealChannel>()
+      .AddAttribute("Delay", "Propagation delay through the channel",
+        TimeValue(Seconds(0)),
+        MakeTimeAccessor(&IdealChannel::m_delay),
+        MakeTimeChecker());
+    return tid;
+  }
+
+  IdealChannel();
+
+  void Attach(Ptr<IdealNetDevice> device);
+
+  std::size_t GetNDevices() const override {
+    return m_nDevices;
+  }
+
+  Ptr<NetDevice> GetDevice(std::size_t i) const override;
+
+  Ptr<IdealNetDevice> GetPeer(const IdealNetDevice* device) const;
+
+  Time GetDelay() const {
+    return m_delay;
+  }
+
+private:
+  Time m_delay;
+  Ptr<IdealNetDevice> m_devices[2];
+  std::size_t m_nDevices;
+};
+
+/**
+ * \brief NetDevice with analytic serialization and one delivery event per packet
+ *
+ * MaxPackets bounds the number of packets waiting for the transmitter, with the same
+ * meaning as DropTailQueue MaxSize on a PointToPointNetDevice (the packet being
+ * serialized is not counted). Zero means unlimited.
+*/
+class IdealNetDevice : public NetDevice {
+public:
+  static TypeId GetTypeId() {
+    static TypeId tid = TypeId("ns3::IdealNetDevice")
+      .SetParent<NetDevice>()
+      .SetGroupName("Ndn")
+      .AddConstructor<IdealNetDevice>()
+      .AddAttribute("DataRate", "Transmission rate of the device",
+        DataRateValue(DataRate("32768b/s")),
+        MakeDataRateAccessor(&IdealNetDevice::m_dataRate),
+        MakeDataRateChecker())
+      .AddAttribute("Mtu", "MAC-level maximum transmission unit",
+        UintegerValue(1500),
+        MakeUintegerAccessor(&IdealNetDevice::m_mtu),
+        MakeUintegerChecker<uint16_t>())
+      .AddAttribute("FramingOverhead", "Bytes added to every packet for serialization (PPP header)",
+        UintegerValue(2),
+        MakeUintegerAccessor(&IdealNetDevice::m_framingOverhead),
+        MakeUintegerChecker<uint32_t>())
+      .AddAttribute("MaxPackets", "Packets allowed to wait for the transmitter (0 = unlimited)",
+        UintegerValue(0),
+        MakeUintegerAccessor(&IdealNetDevice::m_maxPackets),
+        MakeUintegerChecker<uint32_t>())
+      .AddTraceSource("MacTx", "Packet accepted for transmission",
+        MakeTraceSourceAccessor(&IdealNetDevice::m_txTrace),
+        "ns3::Packet::TracedCallback")
+      .AddTraceSource("MacRx", "Packet delivered to the node",
+        MakeTraceSourceAccessor(&IdealNetDevice::m_rxTrace),
+        "ns3::Packet::TracedCallback")
+      .AddTraceSource("Drop", "Packet dropped because the backlog limit was reached",
+        MakeTraceSourceAccessor(&IdealNetDevice::m_dropTrace),
+        "ns3::Packet::TracedCallback");
+    return tid;
+  }
+
+  IdealNetDevice()
+    : m_ifIndex(0)
+    , m_mtu(1500)
+    , m_framingOverhead(2)
+    , m_maxPackets(0)
+    , m_linkUp(false) {
+  }
+
+  void Attach(Ptr<IdealChannel> channel) {
+    m_channel = channel;
+    m_channel->Attach(this);
+    m_linkUp = true;
+    m_linkChangeCallbacks();
+  }
+
+  /**
+   * \brief Reserve the transmitter for a packet of the given size
+   * \returns delay until the packet is fully received by the peer, or a negative time
+   * if the backlog limit is reached and the packet has to be dropped
+  */
+  Time ReserveTransmission(uint32_t bytes) {
+    Time now = Simulator::Now();
+    while (!m_backlog.empty() && m_backlog.front() <= now) {
+      m_backlog.pop_front();
+    }
+    if (m_maxPackets > 0 && m_backlog.size() > m_maxPackets) {
+      return Time(-1);
+    }
+
+    m_txFreeAt = std::max(now, m_txFreeAt) + m_dataRate.CalculateBytesTxTime(bytes + m_framingOverhead);
+    if (m_maxPackets > 0) {
+      m_backlog.push_back(m_txFreeAt);
+    }
+    return m_txFreeAt - now + m_channel->GetDelay();
+  }
+
+  Ptr<IdealNetDevice> GetPeer() const {
+    return m_channel->GetPeer(this);
+  }
+
+  DataRate GetDataRate() const {
+    return m_dataRate;
+  }
+
+  void Receive(Ptr<Packet> packet, uint16_t protocol) {
+    m_rxTrace(packet);
+    Address from = GetPeer()->GetAddress();
+    if (!m_promiscCallback.IsNull()) {
+      m_promiscCallback(this, packet, protocol, from, m_address, NetDevice::PACKET_HOST);
+    }
+    m_rxCallback(this, packet, protocol, from);
+  }
+
+  // NetDevice interface
+
+  void SetIfIndex(const uint32_t index) override { m_ifIndex = index; }
+  uint32_t GetIfIndex() const override { return m_ifIndex; }
+  Ptr<Channel> GetChannel() const override { return m_channel; }
+  void SetAddress(Address address) override { m_address = Mac48Address::ConvertFrom(address); }
+  Address GetAddress() const override { return m_address; }
+  bool SetMtu(const uint16_t mtu) override { m_mtu = mtu; return true; }
+  uint16_t GetMtu() const override { return m_mtu; }
+  bool IsLinkUp() const override { return m_linkUp; }
+  void AddLinkChangeCallback(Callback<void> callback) override { m_linkChangeCallbacks.ConnectWithoutContext(callback); }
+  bool IsBroadcast() const override { return true; }
+  Address GetBroadcast() const override { return Mac48Address::GetBroadcast(); }
+  bool IsMulticast() const override { return false; }
+  Address GetMulticast(Ipv4Address) const override { return Mac48Address::GetBroadcast(); }
+  Address GetMulticast(Ipv6Address) const override { return Mac48Address::GetBroadcast(); }
+  bool IsPointToPoint() const override { return true; }
+  bool IsBridge() const override { return false; }
+  Ptr<Node> GetNode() const override { return m_node; }
+  void SetNode(Ptr<Node> node) override { m_node = node; }
+  bool NeedsArp() const override { return false; }
+  void SetReceiveCallback(NetDevice::ReceiveCallback cb) override { m_rxCallback = cb; }
+  void SetPromiscReceiveCallback(NetDevice::PromiscReceiveCallback cb) override { m_promiscCallback = cb; }
+  bool SupportsSendFrom() const override { return false; }
+
+  bool Send(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber) override {
+    if (!m_linkUp || packet->GetSize() > m_mtu) {
+      m_dropTrace(packet);
+      return false;
+    }
+
+    Time delay = ReserveTransmission(packet->GetSize());
+    if (delay.IsNegative()) {
+      m_dropTrace(packet);
+      return false;
+    }
+
+    m_txTrace(packet);
+    Ptr<IdealNetDevice> peer = GetPeer();
+    Simulator::ScheduleWithContext(peer->GetNode()->GetId(), delay,
+      &IdealNetDevice::Receive, peer, packet, protocolNumber);
+    return true;
+  }
+
+  bool SendFrom(Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber) override {
+    return false;
+  }
+
+protected:
+  void DoDispose() override {
+    m_node = 0;
+    m_channel = 0;
+    m_rxCallback.Nullify();
+    m_promiscCallback.Nullify();
+    NetDevice::DoDispose();
+  }
+
+private:
+  Ptr<Node> m_node;
+  Ptr<IdealChannel> m_channel;
+  Mac48Address m_address;
+  uint32_t m_ifIndex;
+  DataRate m_dataRate;
+  uint16_t m_mtu;
+  uint32_t m_framingOverhead;
+  uint32_t m_maxPackets;
+  bool m_linkUp;
+
+  Time m_txFreeAt;
+  std::deque<Time> m_backlog; // completion times of packets not yet fully serialized
+
+  NetDevice::ReceiveCallback m_rxCallback;
+  NetDevice::PromiscReceiveCallback m_promiscCallback;
+  TracedCallback<> m_linkChangeCallbacks;
+  TracedCallback<Ptr<const Packet>> m_txTrace;
+  TracedCallback<Ptr<const Packet>> m_rxTrace;
+  TracedCallback<Ptr<const Packet>> m_dropTrace;
+};
+
+inline IdealChannel::IdealChannel()
+  : m_nDevices(0) {
+}
+
+inline void IdealChannel::Attach(Ptr<IdealNetDevice> device) {
+  NS_ASSERT_MSG(m_nDevices < 2, "IdealChannel supports only two devices");
+  m_devices[m_nDevices++] = device;
+}
+
+inline Ptr<NetDevice> IdealChannel::GetDevice(std::size_t i) const {
+  return m_devices[i];
+}
+
+inline Ptr<IdealNetDevice> IdealChannel::GetPeer(const IdealNetDevice* device) const {
+  return m_devices[0] == device ? m_devices[1] : m_devices[0];
+}
+
+NS_OBJECT_ENSURE_REGISTERED(IdealChannel);
+NS_OBJECT_ENSURE_REGISTERED(IdealNetDevice);
+
+/**
+ * \brief Drop-in replacement for PointToPointHelper that installs ideal links
+ *
+ * "MaxPackets" on the device plays the role of DropTailQueue<Packet>::MaxSize.
+*/
+class IdealLinkHelper {
+public:
+  IdealLinkHelper() {
+    m_deviceFactory.SetTypeId("ns3::IdealNetDevice");
+    m_channelFactory.SetTypeId("ns3::IdealChannel");
+  }
+
+  void SetDeviceAttribute(std::string name, const AttributeValue& value) {
+    m_deviceFactory.Set(name, value);
+  }
+
+  void SetChannelAttribute(std::string name, const AttributeValue& value) {
+    m_channelFactory.Set(name, value);
+  }
+
+  NetDeviceContainer Install(NodeContainer c) {
+    NS_ASSERT(c.GetN() == 2);
+    return Install(c.Get(0), c.Get(1));
+  }
+
+  NetDeviceContainer Install(std::string aName, std::string bName) {
+    return Install(Names::Find<Node>(aName), Names::Find<Node>(bName));
+  }
+
+  NetDeviceContainer Install(Ptr<Node> a, Ptr<Node> b) {
+    Ptr<IdealChannel> channel = m_channelFactory.Create<IdealChannel>();
+    NetDeviceContainer container;
+
+    for (Ptr<Node> node : { a, b }) {
+      Ptr<IdealNetDevice> device = m_deviceFactory.Create<IdealNetDevice>();
+      device->SetAddress(Mac48Address::Allocate());
+      node->AddDevice(device);
+      device->Attach(channel);
+      container.Add(device);
+    }
+    return container;
+  }
+
+private:
+  ObjectFactory m_deviceFactory;
+  ObjectFactory m_channelFactory;
+};
+
+/**
+ * \brief AnnotatedTopologyReader that builds its links with IdealLinkHelper
+ *
+ * Reads the same file format (router / link sections) and produces the same nodes,
+ * names and positions; only the link type differs. LossRate is ignored.
+*/
+class IdealLinkTopologyReader : public AnnotatedTopologyReader {
+public:
+  IdealLinkTopologyReader(const std::string& path = "", double scale = 1.0)
+    : AnnotatedTopologyReader(path, scale)
+    , m_scale(scale) {
+  }
+
+  NodeContainer Read() override {
+    std::ifstream topgen(GetFileName().c_str());
+    if (!topgen.is_open() || !topgen.good()) {
+      NS_FATAL_ERROR("Cannot open file " << GetFileName() << " for reading");
+    }
+
+    std::string line;
+    while (std::getline(topgen, line) && line != "router") {
+    }
+    if (topgen.eof()) {
+      NS_FATAL_ERROR("Topology file " << GetFileName() << " does not have \"router\" section");
+    }
+
+    Ptr<UniformRandomVariable> var = CreateObject<UniformRandomVariable>();
+    while (std::getline(topgen, line) && line != "link") {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+
+      std::istringstream lineBuffer(line);
+      std::string name, city;
+      double latitude = 0, longitude = 0;
+      uint32_t systemId = 0;
+      lineBuffer >> name >> city >> latitude >> longitude >> systemId;
+      if (name.empty()) {
+        continue;
+      }
+
+      if (std::abs(latitude) > 0.001 && std::abs(longitude) > 0.001) {
+        CreateNode(name, m_scale * longitude, -m_scale * latitude, systemId);
+      }
+      else {
+        CreateNode(name, var->GetValue(0, 200), var->GetValue(0, 200), systemId);
+      }
+    }
+
+    std::map<std::string, std::set<std::string>> processedLinks; // to eliminate duplications
+    IdealLinkHelper helper;
+
+    while (std::getline(topgen, line)) {
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+
+      std::istringstream lineBuffer(line);
+      std::string from, to, capacity, metric, delay, maxPackets;
+      lineBuffer >> from >> to >> capacity >> metric >> delay >> maxPackets;
+
+      if (processedLinks[to].count(from) != 0) {
+        continue;
+      }
+      processedLinks[from].insert(to);
+
+      Ptr<Node> fromNode = Names::Find<Node>(m_path, from);
+      NS_ASSERT_MSG(fromNode != 0, from << " node not found");
+      Ptr<Node> toNode = Names::Find<Node>(m_path, to);
+      NS_ASSERT_MSG(toNode != 0, to << " node not found");
+
+      Link link(fromNode, from, toNode, to);
+      link.SetAttribute("DataRate", capacity);
+      link.SetAttribute("OSPF", metric);
+      helper.SetDeviceAttribute("DataRate", StringValue(capacity));
+
+      if (!delay.empty()) {
+        link.SetAttribute("Delay", delay);
+        helper.SetChannelAttribute("Delay", StringValue(delay));
+      }
+      if (!maxPackets.empty()) {
+        link.SetAttribute("MaxPackets", maxPackets);
+        helper.SetDeviceAttribute("MaxPackets", StringValue(maxPackets));
+      }
+
+      NetDeviceContainer nd = helper.Install(fromNode, toNode);
+      link.SetNetDevices(nd.Get(0), nd.Get(1));
+      AddLink(link);
+    }
+
+    return m_nodes;
+  }
+
+private:
+  double m_scale;
+};
+
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_IDEAL_LINK_HPP
@@ -0,0 +1,283 @@
+#ifndef NDNSIM_SCRATCH_INCREMENTAL_SPF_HPP
+#define NDNSIM_SCRATCH_INCREMENTAL_SPF_HPP
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief Shortest path tree of one root, repaired incrementally as link states change
+ *
+ * Links are set per node, as announced by its link state advertisement. A link u->v is
+ * used only if v announces a link back to u (two-way check), with u's cost. SetLinks
+ * records which directed links changed; Update then repairs the tree:
+ *
+ * - a link that got worse or disappeared only matters if it is a tree link: the subtree
+ *   below it is detached and re-attached from its intact neighbours
+ * - a link that got better or appeared relaxes its head
+ *
+ * after which one Dijkstra pass runs from the seeded nodes only. Work is proportional to
+ * the part of the tree that actually changes, not to the whole graph. Node ids are
+ * dense (ns-3 node ids); the arrays grow as larger ids are seen.
+*/
+class IncrementalSpf {
+public:
+  static constexpr uint64_t INF = UINT64_MAX;
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  explicit IncrementalSpf(uint32_t root)
+    : m_root(root)
+    , m_settled(0) {
+    Grow(root);
+    m_dist[root] = 0;
+  }
+
+  /**
+   * \brief Replace the links announced by node u (neighbour id, cost >= 1)
+  */
+  void SetLinks(uint32_t u, const std::vector<std::pair<uint32_t, uint64_t>>& links) {
+    Grow(u);
+    for (const std::pair<uint32_t, uint64_t>& link : links) {
+      Grow(link.first);
+    }
+
+    // the directed links whose effective cost may change: u->v and v->u for old and new v
+    std::vector<uint32_t> neighbours;
+    for (const std::pair<const uint32_t, uint64_t>& link : m_links[u]) {
+      neighbours.push_back(link.first);
+    }
+    for (const std::pair<uint32_t, uint64_t>& link : links) {
+      if (m_links[u].count(link.first) == 0) {
+        neighbours.push_back(link.first);
+      }
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> before;
+    for (uint32_t v : neighbours) {
+      before.emplace_back(Weight(u, v), Weight(v, u));
+    }
+
+    m_links[u].clear();
+    for (const std::pair<uint32_t, uint64_t>& link : links) {
+      if (link.first != u) {
+        m_links[u][link.first] = link.second;
+      }
+    }
+
+    for (std::size_t i = 0; i < neighbours.size(); i++) {
+      uint32_t v = neighbours[i];
+      if (Weight(u, v) != before[i].first) {
+        m_changes.push_back(Change{ u, v, before[i].first, Weight(u, v) });
+      }
+      if (Weight(v, u) != before[i].second) {
+        m_changes.push_back(Change{ v, u, before[i].second, Weight(v, u) });
+      }
+    }
+  }
+
+  /**
+   * \brief Apply the changes recorded since the last call
+   * \returns nodes whose distance or first hop changed
+  */
+  const std::vector<uint32_t>& Update() {
+    m_changed.clear();
+    if (m_changes.empty()) {
+      return m_changed;
+    }
+
+    // a link changed several times since the last update counts once, from the cost the
+    // tree was built with to its current one
+    std::unordered_map<uint64_t, std::size_t> seen;
+    std::size_t kept = 0;
+    for (const Change& change : m_changes) {
+      auto first = seen.emplace((static_cast<uint64_t>(change.u) << 32) | change.v, kept);
+      if (first.second) {
+        m_changes[kept++] = change;
+      }
+    }
+    m_changes.resize(kept);
+    for (Change& change : m_changes) {
+      change.after = Weight(change.u, change.v);
+    }
+
+    // worse tree links: detach the subtrees below them
+    std::vector<uint32_t> detached;
+    for (const Change& change : m_changes) {
+      if (change.after > change.before && m_parent[change.v] == change.u) {
+        detached.push_back(change.v);
+      }
+    }
+    if (!detached.empty()) {
+      std::vector<std::vector<uint32_t>> children(m_dist.size());
+      for (uint32_t v = 0; v < m_parent.size(); v++) {
+        if (m_parent[v] != NONE) {
+          children[m_parent[v]].push_back(v);
+        }
+      }
+
+      std::vector<uint32_t> subtree;
+      for (std::size_t i = 0; i < detached.size(); i++) {
+        uint32_t v = detached[i];
+        if (m_dist[v] == INF) {
+          continue; // already detached with an ancestor
+        }
+        Touch(v);
+        m_dist[v] = INF;
+        m_parent[v] = NONE;
+        m_first[v] = NONE;
+        subtree.push_back(v);
+        for (uint32_t child : children[v]) {
+          detached.push_back(child);
+        }
+      }
+
+      // re-attach from intact neighbours
+      for (uint32_t v : subtree) {
+        for (const std::pair<const uint32_t, uint64_t>& link : m_links[v]) {
+          uint32_t x = link.first;
+          uint64_t w = Weight(x, v);
+          if (w != INF && m_dist[x] != INF) {
+            Relax(x, v, w);
+          }
+        }
+      }
+    }
+
+    // better links: relax their heads
+    for (const Change& change : m_changes) {
+      if (change.after < change.before && m_dist[change.u] != INF) {
+        Relax(change.u, change.v, change.after);
+      }
+    }
+    m_changes.clear();
+
+    while (!m_heap.empty()) {
+      std::pair<uint64_t, uint32_t> top = m_heap.top();
+      m_heap.pop();
+      uint32_t v = top.second;
+      if (top.first != m_dist[v]) {
+        continue; // stale
+      }
+      m_settled++;
+      for (const std::pair<const uint32_t, uint64_t>& link : m_links[v]) {
+        uint64_t w = Weight(v, link.first);
+        if (w != INF) {
+          Relax(v, link.first, w);
+        }
+      }
+    }
+
+    for (uint32_t v : m_touched) {
+      if (m_dist[v] != m_oldDist[v] || m_first[v] != m_oldFirst[v]) {
+        m_changed.push_back(v);
+      }
+      m_isTouched[v] = false;
+    }
+    m_touched.clear();
+    return m_changed;
+  }
+
+  uint64_t Distance(uint32_t v) const {
+    return v < m_dist.size() ? m_dist[v] : INF;
+  }
+
+  /**
+   * \brief Neighbour of the root on the path to v, NONE if v is unreachable or the root
+  */
+  uint32_t FirstHop(uint32_t v) const {
+    return v < m_first.size() ? m_first[v] : NONE;
+  }
+
+  uint32_t Parent(uint32_t v) const {
+    return v < m_parent.size() ? m_parent[v] : NONE;
+  }
+
+  /**
+   * \brief Cost of u->v as used by the tree, INF if the link is not two-way
+  */
+  uint64_t Weight(uint32_t u, uint32_t v) const {
+    auto forward = m_links[u].find(v);
+    if (forward == m_links[u].end() || m_links[v].count(u) == 0) {
+      return INF;
+    }
+    return forward->second;
+  }
+
+  /**
+   * \brief Nodes settled by Dijkstra over all updates (work done)
+  */
+  uint64_t GetSettled() const {
+    return m_settled;
+  }
+
+  uint32_t GetRoot() const {
+    return m_root;
+  }
+
+private:
+  struct Change {
+    uint32_t u;
+    uint32_t v;
+    uint64_t before;
+    uint64_t after;
+  };
+
+  void Grow(uint32_t v) {
+    if (v < m_dist.size()) {
+      return;
+    }
+    std::size_t size = v + 1;
+    m_links.resize(size);
+    m_dist.resize(size, INF);
+    m_parent.resize(size, NONE);
+    m_first.resize(size, NONE);
+    m_oldDist.resize(size, INF);
+    m_oldFirst.resize(size, NONE);
+    m_isTouched.resize(size, false);
+  }
+
+  void Touch(uint32_t v) {
+    if (!m_isTouched[v]) {
+      m_isTouched[v] = true;
+      m_oldDist[v] = m_dist[v];
+      m_oldFirst[v] = m_first[v];
+      m_touched.push_back(v);
+    }
+  }
+
+  void Relax(uint32_t x, uint32_t v, uint64_t w) {
+    uint64_t candidate = m_dist[x] + w;
+    if (v == m_root || candidate >= m_dist[v]) {
+      return;
+    }
+    Touch(v);
+    m_dist[v] = candidate;
+    m_parent[v] = x;
+    m_first[v] = x == m_root ? v : m_first[x];
+    m_heap.emplace(candidate, v);
+  }
+
+private:
+  uint32_t m_root;
+  std::vector<std::unordered_map<uint32_t, uint64_t>> m_links; // as announced: node -> neighbour -> cost
+  std::vector<uint64_t> m_dist;
+  std::vector<uint32_t> m_parent;
+  std::vector<uint32_t> m_first;
+
+  std::vector<Change> m_changes;
+  std::priority_queue<std::pair<uint64_t, uint32_t>, std::vector<std::pair<uint64_t, uint32_t>>,
+                      std::greater<std::pair<uint64_t, uint32_t>>> m_heap;
+
+  std::vector<uint32_t> m_touched; // nodes changed by the current update, with their old state
+  std::vector<bool> m_isTouched;
+  std::vector<uint64_t> m_oldDist;
+  std::vector<uint32_t> m_oldFirst;
+  std::vector<uint32_t> m_changed;
+
+  uint64_t m_settled;
+};
+
+#endif // NDNSIM_SCRATCH_INCREMENTAL_SPF_HPP
@@ -7,6 +7,10 @@
 #include <ns3/ndnSIM/utils/tracers/custom-cs-tracer.hpp>
 #include <ns3/ndnSIM/utils/tracers/custom-fib-tracer.hpp>
 
+#include "custom-app-delay-aggregate-tracer.hpp"
+#include "custom-flow-tracer.hpp"
+#include "custom-queue-tracer.hpp"
+
 namespace ns3 {
 
   int
@@ -18,9 +22,20 @@ namespace ns3 {
     Config::SetDefault("ns3::DropTailQueue<Packet>::MaxSize", StringValue("10p"));
 
     // Read optional command-line parameters (e.g., enable visualizer with ./waf --run=<> --visualize
+    bool aggregateDelay = false;
+    bool queueTrace = false;
+    std::string consumer = "cbr";
+
     CommandLine cmd;
+    cmd.AddValue("aggregateDelay", "Trace per-interval delay percentiles instead of every interest", aggregateDelay);
+    cmd.AddValue("queueTrace", "Trace per-face queue occupancy, sojourn time and drop causes", queueTrace);
+    cmd.AddValue("consumer", "Consumer: cbr (fixed Frequency), aimd or cubic (congestion window)", consumer);
     cmd.Parse(argc, argv);
 
+    if (consumer != "cbr" && consumer != "aimd" && consumer != "cubic") {
+      NS_FATAL_ERROR("Unknown consumer " << consumer << " (cbr, aimd or cubic)");
+    }
+
     // Creating 3x3 topology
     PointToPointHelper p2p;
     PointToPointGridHelper grid(3, 3, p2p);
@@ -52,11 +67,19 @@ namespace ns3 {
     // Install NDN applications
     std::string prefix = "/prefix";
 
-    ndn::AppHelper consumerHelper("ns3::ndn::ConsumerCbr");
-    consumerHelper.SetPrefix(prefix);
-    consumerHelper.SetAttribute("Randomize", ns3::StringValue("uniform"));
-    consumerHelper.SetAttribute("Frequency", StringValue("100")); // 100 interests a second
-    consumerHelper.Install(consumerNodes);
+    if (consumer == "cbr") {
+      ndn::AppHelper consumerHelper("ns3::ndn::ConsumerCbr");
+      consumerHelper.SetPrefix(prefix);
+      consumerHelper.SetAttribute("Randomize", ns3::StringValue("uniform"));
+      consumerHelper.SetAttribute("Frequency", StringValue("100")); // 100 interests a second
+      consumerHelper.Install(consumerNodes);
+    }
+    else {
+      ndn::AppHelper consumerHelper("ns3::ndn::ConsumerAimd");
+      consumerHelper.SetPrefix(prefix);
+      consumerHelper.SetAttribute("Algorithm", StringValue(consumer));
+      consumerHelper.Install(consumerNodes);
+    }
 
     ndn::AppHelper producerHelper("ns3::ndn::Producer");
     producerHelper.SetPrefix(prefix);
@@ -69,10 +92,21 @@ namespace ns3 {
     // Calculate and install FIBs
     ndn::GlobalRoutingHelper::CalculateRoutes();
 
-    ns3::ndn::AppDelayTracer::InstallAll("./scratch/main-app-delay-trace.txt");
+    if (aggregateDelay) {
+      ns3::ndn::custom::AppDelayAggregateTracer::InstallAll("./scratch/main-app-delay-aggregate-trace.txt", Seconds(1.0));
+    }
+    else {
+      ns3::ndn::AppDelayTracer::InstallAll("./scratch/main-app-delay-trace.txt");
+    }
     ns3::ndn::L3RateTracer::InstallAll("./scratch/main-l3-packet-trace.txt");
     ns3::ndn::CsTracer::InstallAll("./scratch/main-cs-tracer.txt");
     ns3::ndn::custom::CsTracer::InstallAll("./scratch/main-custom-cs-tracer.txt");
+    if (queueTrace) {
+      ns3::ndn::custom::QueueTracer::InstallAll("./scratch/main-queue-tracer.txt", Seconds(1.0));
+    }
+    if (consumer != "cbr") {
+      ns3::ndn::custom::FlowTracer::Install(consumerNodes, "./scratch/main-flow-tracer.txt", Seconds(1.0));
+    }
 
 
     Simulator::Stop(Seconds(20.0));
@@ -13,6 +13,12 @@
 #include <ns3/ndnSIM/utils/tracers/custom-cs-tracer.hpp>
 #include <ns3/ndnSIM/utils/tracers/custom-fib-tracer.hpp>
 
+#include "ndn-consumer-zipf-alias.hpp"
+#include "ndn-consumer-flow-group.hpp"
+#include "ndn-node-stats.hpp"
+#include "ndn-node-stats-format.hpp"
+#include "custom-cs-access-recorder.hpp"
+
 /**
  * how to read using command line in ns3
  *
@@ -96,29 +102,11 @@ namespace util {
 
 
   void getNodeInfo(ns3::Ptr<ns3::Node> ptrNode, std::string path) {
-    ns3::Ptr<ns3::ndn::L3Protocol> l3pt = ptrNode->GetObject<ns3::ndn::L3Protocol>();
-    if (l3pt != 0) {
-      std::cout << "NodeInfo [ " << ptrNode->GetId() << " ]\n";
-      ns3::ndn::nfd::Cs& cs = l3pt->getForwarder()->getCs();
-      std::cout << "Cs-Policy : " << cs.getPolicy()->getName() << "\n";
-      std::cout << "Cs-Stored Packets : " << cs.size() << "\n";
-      std::cout << "Cs-Size : " << cs.getLimit() << "\n";
-      std::cout << "Face-Table-Count : " << l3pt->getFaceTable().size() << "\n";
-
-      std::cout << "Face-Table Items\n";
-      ns3::ndn::nfd::FaceTable& faceTable = l3pt->getFaceTable();
-      int count = 1;
-
-      // index face-id face-scope
-
-      for (const ns3::ndn::Face& face : faceTable) {
-        std::cout << std::setw(4) << std::right << count << ") ";
-        std::cout << std::setw(3) << std::right << face.getId() << " ";
-        std::cout << std::setw(6) << std::right << face.getState() << " ";
-        std::cout << std::setw(10) << std::right << face.getScope() << "\n";
-        count++;
-      }
-      std::cout << "\n";
+    static ns3::ndn::stats::NodeStats nodeStats; // large, keep it off the stack
+
+    ns3::ndn::stats::Collect(ptrNode, nodeStats);
+    if (nodeStats.hasNdn) {
+      ns3::ndn::stats::WriteText(std::cout, &nodeStats, 1);
     }
     else {
       std::cerr << "Ndn is not installed in the given node\n";
@@ -126,7 +114,7 @@ namespace util {
   }
 }
 
-void run() {
+void run(const std::string& consumerType, const std::string& csRecord, uint32_t flows) {
 
   ns3::NodeContainer nodes;
   nodes.Create(3);
@@ -159,28 +147,39 @@ void run() {
   routingHelper.InstallAll();
   routingHelper.AddOrigin(prefix, nodes.Get(2));
 
-  ns3::ndn::AppHelper consumerApp("ns3::ndn::ConsumerCbr");
-  consumerApp.SetPrefix(prefix);
-
   ns3::ndn::StrategyChoiceHelper::InstallAll("/prefix", "/localhost/nfd/strategy/multicast");
 
-  consumerApp.SetAttribute("Frequency", ns3::DoubleValue(10));
-  consumerApp.SetAttribute("Randomize", ns3::StringValue("uniform"));
-  consumerApp.SetPrefix("prefix-1");
+  if (flows > 0) {
+    // all the logical clients behind node 0 in one application: prefix-1/<flow>/<seq>
+    ns3::ndn::AppHelper flowGroupApp("ns3::ndn::ConsumerFlowGroup");
+    flowGroupApp.SetPrefix(prefix);
+    flowGroupApp.SetAttribute("Flows", ns3::UintegerValue(flows));
+    flowGroupApp.SetAttribute("Frequency", ns3::DoubleValue(20.0 / flows));
+    flowGroupApp.SetAttribute("Randomize", ns3::StringValue("exponential"));
+    util::SetTime(flowGroupApp.Install(nodes.Get(0)), { {1,10} });
+  }
+  else {
+    ns3::ndn::AppHelper consumerApp(consumerType);
+    consumerApp.SetPrefix(prefix);
 
-  ns3::ApplicationContainer consAppCont = consumerApp.Install(nodes.Get(0));
+    consumerApp.SetAttribute("Frequency", ns3::DoubleValue(10));
+    consumerApp.SetAttribute("Randomize", ns3::StringValue("uniform"));
+    consumerApp.SetPrefix("prefix-1");
 
-  for (ns3::ApplicationContainer::Iterator i = consAppCont.Begin(); i != consAppCont.End(); ++i) {
-    (*i)->SetStartTime(ns3::Seconds(1));
-    (*i)->SetStopTime(ns3::Seconds(10));
-  }
+    ns3::ApplicationContainer consAppCont = consumerApp.Install(nodes.Get(0));
 
-  ns3::ndn::AppHelper consAppHelpr("ns3::ndn::ConsumerCbr");
-  consAppHelpr.SetPrefix("prefix-1");
-  consAppHelpr.SetAttribute("Frequency", ns3::DoubleValue(10));
-  consAppHelpr.SetAttribute("Randomize", ns3::StringValue("uniform"));
+    for (ns3::ApplicationContainer::Iterator i = consAppCont.Begin(); i != consAppCont.End(); ++i) {
+      (*i)->SetStartTime(ns3::Seconds(1));
+      (*i)->SetStopTime(ns3::Seconds(10));
+    }
 
-  consAppHelpr.Install(nodes.Get(0));
+    ns3::ndn::AppHelper consAppHelpr(consumerType);
+    consAppHelpr.SetPrefix("prefix-1");
+    consAppHelpr.SetAttribute("Frequency", ns3::DoubleValue(10));
+    consAppHelpr.SetAttribute("Randomize", ns3::StringValue("uniform"));
+
+    consAppHelpr.Install(nodes.Get(0));
+  }
 
   // consAppCont = consumerApp.Install(nodes.Get(0));
 
@@ -199,6 +198,10 @@ void run() {
   ns3::ndn::CsTracer::InstallAll("./scratch/cs-tracer-main1.txt", ns3::Seconds(2));
   ns3::ndn::custom::CsTracer::InstallAll("./scratch/custom-cs-tracer-main1.txt", ns3::Seconds(2));
   ns3::ndn::custom::FibTracer::InstallAll("./scratch/custom-fib-tracer-main1.txt", ns3::Seconds(2));
+  if (!csRecord.empty()) {
+    // replay offline with: cs-replay <file> --sizes=... --policies=opt,lru,fifo
+    ns3::ndn::custom::CsAccessRecorder::InstallAll(csRecord);
+  }
 
   // // util::getNodeInfo(nodes.Get(0), "");
   // // util::getNodeInfo(nodes.Get(1), "");
@@ -234,6 +237,9 @@ void run() {
   // routingHelper.CalculateRoutes();
   ns3::Simulator::Stop(ns3::Seconds(50));
   ns3::Simulator::Run();
+  if (flows > 0) {
+    ns3::ndn::ConsumerFlowGroup::PrintStats(std::cout);
+  }
   ns3::Simulator::Destroy();
 }
 
@@ -249,7 +255,17 @@ int main(int argc, char* argv[]) {
   // cmd.AddValue<bool>("iamboy", "are you a boy?", iamboy);
   // cmd.AddValue<int>("testlevel", "your testostreonelevel", testostreonelevel);
 
+  // e.g. ns3::ndn::ConsumerZipfAlias for Zipf-Mandelbrot popularity (NumberOfContents, q, s)
+  std::string consumerType = "ns3::ndn::ConsumerCbr";
+  cmd.AddValue("consumer", "consumer application type", consumerType);
+
+  std::string csRecord; // binary CS lookup/insert stream for cs-replay
+  cmd.AddValue("csRecord", "record every CS access of every node to this file", csRecord);
+
+  uint32_t flows = 0; // logical clients simulated by one ConsumerFlowGroup instead of the consumers
+  cmd.AddValue("flows", "simulate this many clients on node 0 with one ConsumerFlowGroup (0: two consumers)", flows);
+
   cmd.Parse(argc, argv);
 
-  run();
+  run(consumerType, csRecord, flows);
 }
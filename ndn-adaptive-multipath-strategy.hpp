@@ -0,0 +1,356 @@
+#ifndef NDNSIM_SCRATCH_NDN_ADAPTIVE_MULTIPATH_STRATEGY_HPP
+#define NDNSIM_SCRATCH_NDN_ADAPTIVE_MULTIPATH_STRATEGY_HPP
+
+#include "ns3/node-list.h"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/NFD/daemon/common/global.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/algorithm.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/process-nack-traits.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/retx-suppression-exponential.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/strategy.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/strategy-choice.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nfd {
+namespace fw {
+
+/**
+ * \brief Splits interests over the k best next hops, ranked by measured RTT and loss
+ *
+ *     ndn::StrategyChoiceHelper::InstallAll("/prefix", "/localhost/nfd/strategy/adaptive-multipath");
+ *     ndn::StrategyChoiceHelper::InstallAll("/prefix", "/localhost/nfd/strategy/adaptive-multipath/%FD%01/k~3/probe-interval~32");
+ *
+ * For every FIB prefix and next hop the strategy keeps an SRTT (from the out record to
+ * the Data) and a loss rate (EWMA of Data = 0, Nack or no Data within SRTT + 4 RTTVAR = 1).
+ * A next hop costs SRTT / (1 - loss), the expected time to get the Data through it.
+ *
+ * Every interest goes to exactly one of the k cheapest next hops (unmeasured ones are
+ * ranked after the measured ones, by FIB cost), chosen by smooth weighted round robin
+ * with weights 1 / cost, so faster producers get proportionally more of the traffic.
+ * Every probe-interval-th interest goes instead to the least recently probed next hop
+ * outside the top k, so the ranking follows paths that get better. Probes are not
+ * duplicates (the Data of a duplicate sent on a slower path would arrive after the PIT
+ * entry is gone and could not be measured): the fan-out is always one.
+ *
+ * A Nacked interest is retried on the best next hop it was not sent to yet. An interest
+ * from a downstream that is not in the PIT entry yet is only aggregated. One from a
+ * downstream already there is a consumer retransmission: unless RetxSuppressionExponential
+ * suppresses it, it counts the attempts still pending as lost and goes to a next hop not
+ * tried yet. PrintStats dumps the per next hop state.
+*/
+class AdaptiveMultipathStrategy : public Strategy, public ProcessNackTraits<AdaptiveMultipathStrategy> {
+public:
+  explicit AdaptiveMultipathStrategy(Forwarder& forwarder, const Name& name = getStrategyName())
+    : Strategy(forwarder)
+    , ProcessNackTraits(this)
+    , m_k(2)
+    , m_probeInterval(16) {
+    ParsedInstanceName parsed = parseInstanceName(name);
+    if (parsed.version && *parsed.version != getStrategyName()[-1].toVersion()) {
+      NDN_THROW(std::invalid_argument("AdaptiveMultipathStrategy does not support version " +
+                                      std::to_string(*parsed.version)));
+    }
+    for (const name::Component& component : parsed.parameters) {
+      std::string parameter(reinterpret_cast<const char*>(component.value()), component.value_size());
+      std::size_t tilde = parameter.find('~');
+      long value = tilde == std::string::npos ? 0 : std::strtol(parameter.c_str() + tilde + 1, nullptr, 10);
+      if (value <= 0) {
+        NDN_THROW(std::invalid_argument("AdaptiveMultipathStrategy expects <parameter>~<positive value>, got " +
+                                        parameter));
+      }
+      if (parameter.compare(0, tilde, "k") == 0) {
+        m_k = static_cast<std::size_t>(value);
+      }
+      else if (parameter.compare(0, tilde, "probe-interval") == 0) {
+        m_probeInterval = static_cast<uint64_t>(value);
+      }
+      else {
+        NDN_THROW(std::invalid_argument("AdaptiveMultipathStrategy has no parameter " + parameter.substr(0, tilde)));
+      }
+    }
+    this->setInstanceName(makeInstanceName(name, getStrategyName()));
+  }
+
+  static const Name& getStrategyName() {
+    static Name strategyName("/localhost/nfd/strategy/adaptive-multipath/%FD%01");
+    return strategyName;
+  }
+
+  void afterReceiveInterest(const FaceEndpoint& ingress, const Interest& interest,
+                            const shared_ptr<pit::Entry>& pitEntry) override {
+    // the forwarder has already added the in-record, so downstreams are tracked here
+    PitInfo& info = *pitEntry->insertStrategyInfo<PitInfo>().first;
+    bool knownDownstream = std::find(info.downstreams.begin(), info.downstreams.end(), ingress.face.getId())
+                           != info.downstreams.end();
+    if (!knownDownstream) {
+      info.downstreams.push_back(ingress.face.getId());
+    }
+    if (pitEntry->hasOutRecords()
+        && (!knownDownstream || m_retxSuppression.decidePerPitEntry(*pitEntry) == RetxSuppressionResult::SUPPRESS)) {
+      return; // aggregated, or retransmitted too soon
+    }
+
+    const fib::Entry& fibEntry = this->lookupFib(*pitEntry);
+    Namespace& ns = m_namespaces[fibEntry.getPrefix()];
+    std::vector<Face*> ranked = Rank(fibEntry, ns, ingress.face, interest);
+    if (ranked.empty()) {
+      this->sendNack(pitEntry, ingress, lp::NackHeader().setReason(lp::NackReason::NO_ROUTE));
+      this->rejectPendingInterest(pitEntry);
+      return;
+    }
+
+    if (pitEntry->hasOutRecords()) {
+      // retransmission: the consumer gave up on the pending attempts
+      for (const auto& timer : info.timers) {
+        Lost(ns.faces[timer.first]);
+      }
+      info.timers.clear();
+      Face* untried = FirstUntried(ranked, *pitEntry);
+      Forward(pitEntry, fibEntry.getPrefix(), ns, untried != nullptr ? *untried : *ranked.front(), interest, false);
+      return;
+    }
+
+    std::size_t k = std::min(m_k, ranked.size());
+    if (++ns.interests % m_probeInterval != 0 || ranked.size() == k) {
+      Forward(pitEntry, fibEntry.getPrefix(), ns, Pick(ns, ranked, k), interest, false);
+    }
+    else {
+      Face* probe = nullptr;
+      uint64_t oldest = std::numeric_limits<uint64_t>::max();
+      for (std::size_t i = k; i < ranked.size(); i++) {
+        uint64_t lastProbe = ns.faces[ranked[i]->getId()].lastProbe;
+        if (lastProbe < oldest) {
+          probe = ranked[i];
+          oldest = lastProbe;
+        }
+      }
+      ns.faces[probe->getId()].lastProbe = ns.interests;
+      Forward(pitEntry, fibEntry.getPrefix(), ns, *probe, interest, true);
+    }
+  }
+
+  void beforeSatisfyInterest(const shared_ptr<pit::Entry>& pitEntry, const FaceEndpoint& ingress,
+                             const Data& data) override {
+    const fib::Entry& fibEntry = this->lookupFib(*pitEntry);
+    auto ns = m_namespaces.find(fibEntry.getPrefix());
+    auto outRecord = pitEntry->getOutRecord(ingress.face);
+    if (ns == m_namespaces.end() || outRecord == pitEntry->out_end()) {
+      return;
+    }
+    CancelTimer(*pitEntry, ingress.face.getId());
+
+    FaceStats& stats = ns->second.faces[ingress.face.getId()];
+    double rtt = time::duration_cast<time::microseconds>(time::steady_clock::now() - outRecord->getLastRenewed())
+                   .count() / 1000.0;
+    if (stats.srtt == 0) {
+      stats.srtt = rtt;
+      stats.rttvar = rtt / 2;
+    }
+    else {
+      stats.rttvar = 0.75 * stats.rttvar + 0.25 * std::abs(stats.srtt - rtt);
+      stats.srtt = 0.875 * stats.srtt + 0.125 * rtt;
+    }
+    stats.loss *= 1 - LOSS_ALPHA;
+    stats.data++;
+  }
+
+  void afterReceiveNack(const FaceEndpoint& ingress, const lp::Nack& nack,
+                        const shared_ptr<pit::Entry>& pitEntry) override {
+    const fib::Entry& fibEntry = this->lookupFib(*pitEntry);
+    Namespace& ns = m_namespaces[fibEntry.getPrefix()];
+    CancelTimer(*pitEntry, ingress.face.getId());
+    Lost(ns.faces[ingress.face.getId()]);
+
+    const pit::InRecordCollection& inRecords = pitEntry->getInRecords();
+    if (!inRecords.empty()) {
+      Face& downstream = inRecords.front().getFace();
+      Face* untried = FirstUntried(Rank(fibEntry, ns, downstream, pitEntry->getInterest()), *pitEntry);
+      if (untried != nullptr) {
+        Forward(pitEntry, fibEntry.getPrefix(), ns, *untried, pitEntry->getInterest(), false);
+        return;
+      }
+    }
+    this->processNack(ingress.face, nack, pitEntry);
+  }
+
+  /**
+   *     Prefix Face SrttMs Loss Sent Probes Data Losses
+  */
+  void Print(std::ostream& os, const std::string& node) const {
+    for (const std::pair<const Name, Namespace>& ns : m_namespaces) {
+      for (const std::pair<const FaceId, FaceStats>& face : ns.second.faces) {
+        const FaceStats& stats = face.second;
+        os << node << "\t" << ns.first << "\t" << face.first << "\t" << stats.srtt << "\t" << stats.loss << "\t"
+           << stats.sent << "\t" << stats.probes << "\t" << stats.data << "\t" << stats.losses << "\n";
+      }
+    }
+  }
+
+  /**
+   *     Node Prefix Face SrttMs Loss Sent Probes Data Losses
+   *
+   * for every node and namespace using the strategy.
+  */
+  static void PrintStats(std::ostream& os) {
+    os << "Node" << "\t" << "Prefix" << "\t" << "Face" << "\t" << "SrttMs" << "\t" << "Loss" << "\t" << "Sent"
+       << "\t" << "Probes" << "\t" << "Data" << "\t" << "Losses" << "\n";
+    for (ns3::NodeList::Iterator node = ns3::NodeList::Begin(); node != ns3::NodeList::End(); ++node) {
+      ns3::Ptr<ns3::ndn::L3Protocol> l3 = (*node)->GetObject<ns3::ndn::L3Protocol>();
+      if (l3 == 0) {
+        continue;
+      }
+      for (const strategy_choice::Entry& entry : l3->getForwarder()->getStrategyChoice()) {
+        const AdaptiveMultipathStrategy* strategy = dynamic_cast<const AdaptiveMultipathStrategy*>(&entry.getStrategy());
+        if (strategy != nullptr) {
+          strategy->Print(os, std::to_string((*node)->GetId()));
+        }
+      }
+    }
+  }
+
+protected:
+  static constexpr double LOSS_ALPHA = 0.125;
+  static constexpr double MIN_RTO_MS = 20;
+  static constexpr double MAX_RTO_MS = 1000;
+
+  struct FaceStats {
+    double srtt = 0;    // ms, 0 until the first Data
+    double rttvar = 0;  // ms
+    double loss = 0;    // EWMA of loss indications
+    double credit = 0;  // smooth weighted round robin
+    uint64_t lastProbe = 0;
+    uint64_t sent = 0;
+    uint64_t probes = 0;
+    uint64_t data = 0;
+    uint64_t losses = 0;
+  };
+
+  struct Namespace {
+    std::unordered_map<FaceId, FaceStats> faces;
+    uint64_t interests = 0;
+  };
+
+  /**
+   * \brief Loss timers of the next hops an interest was sent to, and the downstream faces
+   * it came from
+  */
+  class PitInfo : public StrategyInfo {
+  public:
+    static constexpr int getTypeId() {
+      return 9044;
+    }
+
+    std::unordered_map<FaceId, ndn::scheduler::ScopedEventId> timers;
+    std::vector<FaceId> downstreams;
+  };
+
+  static double Cost(const FaceStats& stats) {
+    return stats.srtt / (1 - std::min(stats.loss, 0.95));
+  }
+
+  /**
+   * \brief Eligible next hops, cheapest first; unmeasured ones last, in FIB order
+  */
+  std::vector<Face*> Rank(const fib::Entry& fibEntry, Namespace& ns, const Face& inFace, const Interest& interest) {
+    std::vector<Face*> measured, unmeasured;
+    for (const fib::NextHop& nextHop : fibEntry.getNextHops()) {
+      Face& face = nextHop.getFace();
+      if (face.getId() == inFace.getId() || wouldViolateScope(inFace, interest, face)) {
+        continue;
+      }
+      (ns.faces[face.getId()].srtt > 0 ? measured : unmeasured).push_back(&face);
+    }
+    std::stable_sort(measured.begin(), measured.end(), [&ns](Face* a, Face* b) {
+      return Cost(ns.faces[a->getId()]) < Cost(ns.faces[b->getId()]);
+    });
+    measured.insert(measured.end(), unmeasured.begin(), unmeasured.end());
+    return measured;
+  }
+
+  /**
+   * \brief Smooth weighted round robin over the first k ranked next hops
+  */
+  static Face& Pick(Namespace& ns, const std::vector<Face*>& ranked, std::size_t k) {
+    // unmeasured next hops get the weight of the best one, so they are tried early
+    double bestCost = ns.faces[ranked.front()->getId()].srtt > 0 ? Cost(ns.faces[ranked.front()->getId()]) : 1;
+    double total = 0;
+    Face* chosen = ranked.front();
+    for (std::size_t i = 0; i < k; i++) {
+      FaceStats& stats = ns.faces[ranked[i]->getId()];
+      double weight = 1 / std::max(stats.srtt > 0 ? Cost(stats) : bestCost, 1e-3);
+      stats.credit += weight;
+      total += weight;
+      if (stats.credit > ns.faces[chosen->getId()].credit) {
+        chosen = ranked[i];
+      }
+    }
+    ns.faces[chosen->getId()].credit -= total;
+    return *chosen;
+  }
+
+  static Face* FirstUntried(const std::vector<Face*>& ranked, const pit::Entry& pitEntry) {
+    for (Face* face : ranked) {
+      if (pitEntry.getOutRecord(*face) == pitEntry.out_end()) {
+        return face;
+      }
+    }
+    return nullptr;
+  }
+
+  void Forward(const shared_ptr<pit::Entry>& pitEntry, const Name& prefix, Namespace& ns, Face& face,
+               const Interest& interest, bool probe) {
+    FaceStats& stats = ns.faces[face.getId()];
+    stats.sent++;
+    stats.probes += probe ? 1 : 0;
+
+    // fire before the PIT entry expires, or the loss would go unnoticed
+    double lifetime = time::duration_cast<time::microseconds>(interest.getInterestLifetime()).count() / 1000.0;
+    double rto = stats.srtt > 0 ? std::max(MIN_RTO_MS, stats.srtt + 4 * stats.rttvar) : MAX_RTO_MS;
+    rto = std::min({ rto, MAX_RTO_MS, 0.9 * lifetime });
+    FaceId faceId = face.getId();
+    pitEntry->insertStrategyInfo<PitInfo>().first->timers[faceId] =
+      getScheduler().schedule(time::microseconds(static_cast<int64_t>(rto * 1000)), [this, prefix, faceId] {
+        auto ns = m_namespaces.find(prefix);
+        if (ns != m_namespaces.end()) {
+          Lost(ns->second.faces[faceId]);
+        }
+      });
+
+    this->sendInterest(pitEntry, FaceEndpoint(face, 0), interest);
+  }
+
+  static void CancelTimer(pit::Entry& pitEntry, FaceId faceId) {
+    PitInfo* info = pitEntry.getStrategyInfo<PitInfo>();
+    if (info != nullptr) {
+      info->timers.erase(faceId);
+    }
+  }
+
+  static void Lost(FaceStats& stats) {
+    stats.loss = (1 - LOSS_ALPHA) * stats.loss + LOSS_ALPHA;
+    stats.losses++;
+  }
+
+protected:
+  friend ProcessNackTraits<AdaptiveMultipathStrategy>;
+
+  std::size_t m_k;
+  uint64_t m_probeInterval;
+  RetxSuppressionExponential m_retxSuppression;
+  std::map<Name, Namespace> m_namespaces; // FIB prefix -> next hop state
+};
+
+NFD_REGISTER_STRATEGY(AdaptiveMultipathStrategy);
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NDNSIM_SCRATCH_NDN_ADAPTIVE_MULTIPATH_STRATEGY_HPP
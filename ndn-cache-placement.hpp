@@ -0,0 +1,532 @@
+#ifndef NDNSIM_SCRATCH_NDN_CACHE_PLACEMENT_HPP
+#define NDNSIM_SCRATCH_NDN_CACHE_PLACEMENT_HPP
+
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-global-router.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/model/ndn-net-device-transport.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/cs.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/cs-policy.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/pit.hpp"
+
+#include <ndn-cxx/lp/tags.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <queue>
+#include <stack>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Betweenness centrality of every vertex of an unweighted graph (Brandes)
+ * \param adjacency neighbours of every vertex
+ * \returns centrality normalized so that the most central vertex has 1
+*/
+inline std::vector<double> BetweennessCentrality(const std::vector<std::vector<uint32_t>>& adjacency) {
+  std::size_t n = adjacency.size();
+  std::vector<double> centrality(n, 0);
+  std::vector<std::vector<uint32_t>> predecessors(n);
+  std::vector<double> paths(n);
+  std::vector<int64_t> distance(n);
+  std::vector<double> dependency(n);
+
+  for (uint32_t source = 0; source < n; source++) {
+    std::stack<uint32_t> order;
+    std::queue<uint32_t> frontier;
+    for (uint32_t v = 0; v < n; v++) {
+      predecessors[v].clear();
+      paths[v] = 0;
+      distance[v] = -1;
+      dependency[v] = 0;
+    }
+    paths[source] = 1;
+    distance[source] = 0;
+    frontier.push(source);
+
+    while (!frontier.empty()) {
+      uint32_t v = frontier.front();
+      frontier.pop();
+      order.push(v);
+      for (uint32_t w : adjacency[v]) {
+        if (distance[w] < 0) {
+          distance[w] = distance[v] + 1;
+          frontier.push(w);
+        }
+        if (distance[w] == distance[v] + 1) {
+          paths[w] += paths[v];
+          predecessors[w].push_back(v);
+        }
+      }
+    }
+
+    while (!order.empty()) {
+      uint32_t w = order.top();
+      order.pop();
+      for (uint32_t v : predecessors[w]) {
+        dependency[v] += paths[v] / paths[w] * (1 + dependency[w]);
+      }
+      if (w != source) {
+        centrality[w] += dependency[w];
+      }
+    }
+  }
+
+  double max = *std::max_element(centrality.begin(), centrality.end());
+  if (max > 0) {
+    for (double& c : centrality) {
+      c /= max;
+    }
+  }
+  return centrality;
+}
+
+/**
+ * \brief Fixed number of slots indexed by a 64-bit key, direct mapped
+ *
+ * A key whose slot was taken by a newer one is forgotten, which for per-name state is the
+ * same as the Data having left the caches.
+*/
+template<typename Value>
+class SlotTable {
+public:
+  /**
+   * \param capacity rounded up to a power of two
+  */
+  explicit SlotTable(std::size_t capacity = 1 << 16) {
+    SetCapacity(capacity);
+  }
+
+  /**
+   * \brief Drops every entry
+  */
+  void SetCapacity(std::size_t capacity) {
+    std::size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    m_slots.assign(size, Slot());
+  }
+
+  /**
+   * \brief Entry of key, reset to Value() if its slot held another key
+  */
+  Value& Insert(uint64_t key) {
+    Slot& slot = m_slots[key & (m_slots.size() - 1)];
+    if (!slot.used || slot.key != key) {
+      slot = Slot{ key, true, Value() };
+    }
+    return slot.value;
+  }
+
+  const Value* Find(uint64_t key) const {
+    const Slot& slot = m_slots[key & (m_slots.size() - 1)];
+    return slot.used && slot.key == key ? &slot.value : nullptr;
+  }
+
+private:
+  struct Slot {
+    uint64_t key = 0;
+    bool used = false;
+    Value value = Value();
+  };
+
+  std::vector<Slot> m_slots;
+};
+
+/**
+ * \brief LRU content store policy that decides per Data whether the node keeps a copy
+ *
+ * - Lce: leave copy everywhere (plain LRU, the nfd::cs::lru behaviour)
+ * - Lcd: leave copy down, only the node right below the one that served the Data
+ *   (producer or CS hit) caches it
+ * - ProbCache: cache with probability x / c, x being the hops the Data travelled from
+ *   where it was served and c the hops the Interest travelled to get there
+ * - Betweenness: only the node with the highest betweenness centrality on the Interest
+ *   path caches the Data (centrality from the GlobalRouter graph)
+ *
+ * The decision is taken in doAfterInsert, which the forwarder runs while the PIT entries
+ * of the Data still exist: the Data carries its incoming face (IncomingFaceIdTag) and the
+ * hops from where it was produced (HopCountTag), the in-records the hops of the
+ * Interests. A rejected Data is evicted right away. What cannot be read from the packets
+ * is shared between nodes in fixed-size tables, the simulated equivalent of the fields
+ * LCD/ProbCache/Betw carry: the node and hop count of the CS hit that served a request
+ * (Served) and the highest centrality seen by each Interest (Paths), both by name and
+ * nonce so that an earlier request for the same name is never mistaken for this one.
+*/
+class CachePlacementPolicy : public nfd::cs::Policy {
+public:
+  enum Mode {
+    Lce,
+    Lcd,
+    ProbCache,
+    Betweenness,
+  };
+
+  static const char* ModeName(Mode mode) {
+    switch (mode) {
+    case Lcd:
+      return "lcd";
+    case ProbCache:
+      return "probcache";
+    case Betweenness:
+      return "betweenness";
+    default:
+      return "lce";
+    }
+  }
+
+  /**
+   * \brief CS hit that served one request
+  */
+  struct Hit {
+    uint32_t node = UINT32_MAX;
+    uint64_t dataHops = 0; // HopCountTag of the Data at the hit
+  };
+
+  static SlotTable<Hit>& Served() {
+    static SlotTable<Hit> served;
+    return served;
+  }
+
+  static SlotTable<double>& Paths() {
+    static SlotTable<double> paths;
+    return paths;
+  }
+
+  CachePlacementPolicy(Ptr<Node> node, Mode mode, double centrality)
+    : nfd::cs::Policy(std::string("placement-") + ModeName(mode))
+    , m_nodeId(node->GetId())
+    , m_mode(mode)
+    , m_centrality(centrality)
+    , m_admitted(0)
+    , m_rejected(0) {
+    m_random = CreateObject<UniformRandomVariable>();
+
+    Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+    m_pit = &l3->getForwarder()->getPit();
+    m_faces = &l3->getFaceTable();
+    if (m_mode == Lce) {
+      return;
+    }
+    if (m_mode == Betweenness) {
+      l3->TraceConnectWithoutContext("InInterests", MakeCallback(&CachePlacementPolicy::InInterest, this));
+      return;
+    }
+    m_hitConn = l3->getForwarder()->afterCsHit.connect([this](const Interest& interest, const Data& data) {
+      // the Interest is forwarded with the nonce of one of the downstream in-records
+      Hit& hit = Served().Insert(PathKey(std::hash<Name>()(data.getName()), interest));
+      hit.node = m_nodeId;
+      hit.dataHops = HopCount(data);
+    });
+  }
+
+  uint64_t GetAdmitted() const {
+    return m_admitted;
+  }
+
+  uint64_t GetRejected() const {
+    return m_rejected;
+  }
+
+protected:
+  template<class Packet>
+  static uint64_t HopCount(const Packet& packet) {
+    std::shared_ptr<::ndn::lp::HopCountTag> tag = packet.template getTag<::ndn::lp::HopCountTag>();
+    return tag == nullptr ? 0 : static_cast<uint64_t>(*tag);
+  }
+
+  static uint64_t PathKey(size_t hash, const Interest& interest) {
+    return hash ^ (static_cast<uint64_t>(interest.getNonce()) * 0x9e3779b97f4a7c15ULL);
+  }
+
+  /**
+   * \brief Node on the other side of the face's link, UINT32_MAX if there is none
+  */
+  uint32_t PeerOf(const Face& face) {
+    auto cached = m_peers.find(face.getId());
+    if (cached != m_peers.end()) {
+      return cached->second;
+    }
+
+    uint32_t peer = UINT32_MAX;
+    NetDeviceTransport* transport = dynamic_cast<NetDeviceTransport*>(face.getTransport());
+    if (transport != nullptr && transport->GetNetDevice()->GetChannel() != 0) {
+      Ptr<NetDevice> device = transport->GetNetDevice();
+      Ptr<Channel> channel = device->GetChannel();
+      for (std::size_t i = 0; i < channel->GetNDevices(); i++) {
+        if (channel->GetDevice(i) != device) {
+          peer = channel->GetDevice(i)->GetNode()->GetId();
+        }
+      }
+    }
+    m_peers[face.getId()] = peer;
+    return peer;
+  }
+
+  void InInterest(const Interest& interest, const Face& face) {
+    // a retransmission or another consumer comes with a new nonce, so a new path
+    double& path = Paths().Insert(PathKey(std::hash<Name>()(interest.getName()), interest));
+    path = std::max(path, m_centrality);
+  }
+
+  bool Admit(const Data& data) {
+    std::shared_ptr<::ndn::lp::IncomingFaceIdTag> faceId = data.getTag<::ndn::lp::IncomingFaceIdTag>();
+    Face* face = faceId != nullptr ? m_faces->get(*faceId) : nullptr;
+    if (face == nullptr) {
+      return true;
+    }
+
+    size_t hash = std::hash<Name>()(data.getName());
+    uint64_t dataHops = HopCount(data);
+    nfd::pit::DataMatchResult pitEntries = m_pit->findAllDataMatches(data);
+    const Hit* hit = nullptr;
+    for (const std::shared_ptr<nfd::pit::Entry>& entry : pitEntries) {
+      for (const nfd::pit::InRecord& record : entry->getInRecords()) {
+        if (hit == nullptr) {
+          hit = Served().Find(PathKey(hash, record.getInterest()));
+        }
+      }
+    }
+    // HopCountTag counts from the producer; after a CS hit, from where the hit was. From
+    // a producer app on this node x is 0: LCD keeps it, ProbCache never does
+    bool servedByHit = hit != nullptr && hit->dataHops < dataHops;
+    uint64_t x = servedByHit ? dataHops - hit->dataHops : dataHops;
+
+    switch (m_mode) {
+    case Lcd:
+      return x <= 1 && (!servedByHit || hit->node == PeerOf(*face));
+    case ProbCache: {
+      // c: hops of the Interest to here plus the x hops on to where it was served
+      uint64_t interestHops = 0;
+      for (const std::shared_ptr<nfd::pit::Entry>& entry : pitEntries) {
+        for (const nfd::pit::InRecord& record : entry->getInRecords()) {
+          interestHops = std::max(interestHops, HopCount(record.getInterest()));
+        }
+      }
+      double c = std::max<uint64_t>(interestHops + x, 1);
+      return m_random->GetValue() < std::min(1.0, x / c);
+    }
+    case Betweenness: {
+      double path = 0;
+      for (const std::shared_ptr<nfd::pit::Entry>& entry : pitEntries) {
+        for (const nfd::pit::InRecord& record : entry->getInRecords()) {
+          const double* seen = Paths().Find(PathKey(hash, record.getInterest()));
+          path = std::max(path, seen != nullptr ? *seen : 0);
+        }
+      }
+      return m_centrality >= path;
+    }
+    default:
+      return true;
+    }
+  }
+
+  void doAfterInsert(EntryRef i) override {
+    if (m_mode != Lce && !Admit(i->getData())) {
+      m_rejected++;
+      this->emitSignal(beforeEvict, i);
+      return;
+    }
+
+    m_admitted++;
+    m_queue.push_back(i);
+    m_position[&*i] = std::prev(m_queue.end());
+    this->evictEntries();
+  }
+
+  void doAfterRefresh(EntryRef i) override {
+    MoveToBack(i);
+  }
+
+  void doBeforeErase(EntryRef i) override {
+    auto position = m_position.find(&*i);
+    if (position != m_position.end()) {
+      m_queue.erase(position->second);
+      m_position.erase(position);
+    }
+  }
+
+  void doBeforeUse(EntryRef i) override {
+    MoveToBack(i);
+  }
+
+  void evictEntries() override {
+    while (this->getCs()->size() > this->getLimit() && !m_queue.empty()) {
+      EntryRef i = m_queue.front();
+      m_queue.pop_front();
+      m_position.erase(&*i);
+      this->emitSignal(beforeEvict, i);
+    }
+  }
+
+  void MoveToBack(EntryRef i) {
+    auto position = m_position.find(&*i);
+    if (position != m_position.end()) {
+      m_queue.splice(m_queue.end(), m_queue, position->second);
+    }
+  }
+
+protected:
+  uint32_t m_nodeId;
+  Mode m_mode;
+  double m_centrality;
+  Ptr<UniformRandomVariable> m_random;
+
+  nfd::Pit* m_pit;
+  nfd::FaceTable* m_faces;
+  uint64_t m_admitted;
+  uint64_t m_rejected;
+
+  std::list<EntryRef> m_queue; // LRU order, least recently used first
+  std::unordered_map<const nfd::cs::Entry*, std::list<EntryRef>::iterator> m_position;
+  std::unordered_map<uint64_t, uint32_t> m_peers; // face id -> peer node
+
+  ::ndn::util::signal::ScopedConnection m_hitConn;
+};
+
+/**
+ * \brief Replaces the CS policy of nodes with a CachePlacementPolicy
+ *
+ * Used right after StackHelper::Install (which keeps setting the CS size) and, for the
+ * betweenness mode, after GlobalRoutingHelper::Install, whose adjacencies give the graph.
+ *
+ *     ndn::CachePlacementHelper placement;
+ *     placement.SetMode(ndn::CachePlacementPolicy::Lcd);
+ *     placement.Install(intermediateNodes);
+*/
+class CachePlacementHelper {
+public:
+  CachePlacementHelper()
+    : m_mode(CachePlacementPolicy::Lce) {
+  }
+
+  void SetMode(CachePlacementPolicy::Mode mode) {
+    m_mode = mode;
+  }
+
+  /**
+   * \brief lce, lcd, probcache or betweenness
+  */
+  void SetMode(const std::string& mode) {
+    for (CachePlacementPolicy::Mode m : { CachePlacementPolicy::Lce, CachePlacementPolicy::Lcd,
+                                          CachePlacementPolicy::ProbCache, CachePlacementPolicy::Betweenness }) {
+      if (mode == CachePlacementPolicy::ModeName(m)) {
+        m_mode = m;
+        return;
+      }
+    }
+    NS_FATAL_ERROR("Unknown cache placement mode " << mode);
+  }
+
+  /**
+   * \brief Slots of the shared Served and Paths tables (default 65536 each); names
+   * beyond that many in flight or recently hit are forgotten
+  */
+  static void SetTableSize(std::size_t slots) {
+    CachePlacementPolicy::Served().SetCapacity(slots);
+    CachePlacementPolicy::Paths().SetCapacity(slots);
+  }
+
+  void Install(const NodeContainer& nodes) const {
+    std::vector<double> centrality;
+    if (m_mode == CachePlacementPolicy::Betweenness) {
+      centrality = ComputeCentrality();
+    }
+
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); ++node) {
+      Ptr<L3Protocol> l3 = (*node)->GetObject<L3Protocol>();
+      if (l3 == 0) {
+        continue;
+      }
+      double c = (*node)->GetId() < centrality.size() ? centrality[(*node)->GetId()] : 0;
+      l3->getForwarder()->getCs().setPolicy(std::make_unique<CachePlacementPolicy>(*node, m_mode, c));
+    }
+  }
+
+  void InstallAll() const {
+    Install(NodeContainer::GetGlobal());
+  }
+
+  /**
+   * \brief Admitted and rejected inserts of every node running a CachePlacementPolicy
+   *
+   *     Node Mode Admitted Rejected
+  */
+  static void PrintStats(std::ostream& os) {
+    os << "Node" << "\t" << "Mode" << "\t" << "Admitted" << "\t" << "Rejected" << "\n";
+    ForEachPolicy([&os](Ptr<Node> node, const CachePlacementPolicy& policy) {
+      os << node->GetId() << "\t" << policy.getName() << "\t" << policy.GetAdmitted() << "\t"
+         << policy.GetRejected() << "\n";
+    });
+  }
+
+  /**
+   * \brief Rejected inserts summed over every node running a CachePlacementPolicy
+  */
+  static uint64_t GetRejected() {
+    uint64_t rejected = 0;
+    ForEachPolicy([&rejected](Ptr<Node>, const CachePlacementPolicy& policy) {
+      rejected += policy.GetRejected();
+    });
+    return rejected;
+  }
+
+  /**
+   * \brief Normalized betweenness of every node (index = node id) over the links known
+   * to the GlobalRouters; nodes without a GlobalRouter are isolated
+  */
+  static std::vector<double> ComputeCentrality() {
+    std::vector<std::vector<uint32_t>> adjacency(NodeList::GetNNodes());
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      Ptr<GlobalRouter> router = (*node)->GetObject<GlobalRouter>();
+      if (router == 0) {
+        continue;
+      }
+      for (const GlobalRouter::Incidency& incidency : router->GetIncidencies()) {
+        Ptr<Node> peer = std::get<2>(incidency)->GetObject<Node>();
+        adjacency[(*node)->GetId()].push_back(peer->GetId());
+      }
+    }
+    return BetweennessCentrality(adjacency);
+  }
+
+private:
+  static void ForEachPolicy(const std::function<void(Ptr<Node>, const CachePlacementPolicy&)>& visit) {
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      Ptr<L3Protocol> l3 = (*node)->GetObject<L3Protocol>();
+      if (l3 == 0) {
+        continue;
+      }
+      const CachePlacementPolicy* policy =
+        dynamic_cast<const CachePlacementPolicy*>(l3->getForwarder()->getCs().getPolicy());
+      if (policy != nullptr) {
+        visit(*node, *policy);
+      }
+    }
+  }
+
+private:
+  CachePlacementPolicy::Mode m_mode;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_CACHE_PLACEMENT_HPP
@@ -0,0 +1,264 @@
+#ifndef NDNSIM_SCRATCH_NDN_CONSUMER_AIMD_HPP
+#define NDNSIM_SCRATCH_NDN_CONSUMER_AIMD_HPP
+
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/traced-callback.h"
+#include "ns3/ndnSIM/apps/ndn-consumer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Consumer keeping a congestion window of outstanding interests (AIMD or CUBIC)
+ *
+ * Sequence numbers, retransmissions and the RTT/RTO estimate are the ones of Consumer
+ * (a timeout is an interest unanswered after the estimator's RTO). On top of it:
+ *
+ * - every Data grows the window: +1 below the slow start threshold, then +1/window per
+ *   Data (aimd) or towards the CUBIC curve W(t) = C (t - K)^3 + Wmax (cubic)
+ * - a timeout or a Nack shrinks it (aimd: times Beta, cubic: times CubicBeta), at most
+ *   once per window: losses of interests sent before the last decrease are ignored
+ * - a Nacked interest is retransmitted like a timed out one
+ *
+ * The window is reported through the "Window" trace source on every change; goodput,
+ * retransmissions, timeouts and Nacks are counted for custom::FlowTracer.
+*/
+class ConsumerAimd : public Consumer {
+public:
+  static TypeId GetTypeId() {
+    static TypeId tid = TypeId("ns3::ndn::ConsumerAimd")
+      .SetGroupName("Ndn")
+      .SetParent<Consumer>()
+      .AddConstructor<ConsumerAimd>()
+      .AddAttribute("Algorithm", "Window growth: aimd or cubic",
+        StringValue("aimd"),
+        MakeStringAccessor(&ConsumerAimd::SetAlgorithm, &ConsumerAimd::GetAlgorithm),
+        MakeStringChecker())
+      .AddAttribute("InitialWindow", "Initial congestion window (interests)",
+        DoubleValue(1.0),
+        MakeDoubleAccessor(&ConsumerAimd::m_initialWindow),
+        MakeDoubleChecker<double>(1.0))
+      .AddAttribute("InitialSsthresh", "Initial slow start threshold (interests)",
+        DoubleValue(64.0),
+        MakeDoubleAccessor(&ConsumerAimd::m_initialSsthresh),
+        MakeDoubleChecker<double>(1.0))
+      .AddAttribute("Beta", "Multiplicative decrease of aimd",
+        DoubleValue(0.5),
+        MakeDoubleAccessor(&ConsumerAimd::m_beta),
+        MakeDoubleChecker<double>(0.0, 1.0))
+      .AddAttribute("CubicBeta", "Multiplicative decrease of cubic",
+        DoubleValue(0.7),
+        MakeDoubleAccessor(&ConsumerAimd::m_cubicBeta),
+        MakeDoubleChecker<double>(0.0, 1.0))
+      .AddAttribute("CubicC", "Scaling constant C of cubic",
+        DoubleValue(0.4),
+        MakeDoubleAccessor(&ConsumerAimd::m_cubicC),
+        MakeDoubleChecker<double>(0.0))
+      .AddTraceSource("Window", "Congestion window and interests in flight",
+        MakeTraceSourceAccessor(&ConsumerAimd::m_windowTrace),
+        "ns3::ndn::ConsumerAimd::WindowCallback");
+    return tid;
+  }
+
+  typedef void (*WindowCallback)(Ptr<App>, double, uint32_t);
+
+  /**
+   * \brief Cumulative per flow counters
+  */
+  struct Counters {
+    uint64_t interests = 0; // sent, retransmissions included
+    uint64_t retransmissions = 0;
+    uint64_t timeouts = 0;
+    uint64_t nacks = 0;
+    uint64_t data = 0;      // first Data of every sequence number
+    uint64_t bytes = 0;     // content bytes of those
+  };
+
+  ConsumerAimd()
+    : m_cubic(false)
+    , m_initialWindow(1.0)
+    , m_initialSsthresh(64.0)
+    , m_beta(0.5)
+    , m_cubicBeta(0.7)
+    , m_cubicC(0.4)
+    , m_window(1.0)
+    , m_ssthresh(64.0)
+    , m_inFlight(0)
+    , m_wMax(0)
+    , m_recoverySeq(0) {
+  }
+
+  double GetWindow() const {
+    return m_window;
+  }
+
+  uint32_t GetInFlight() const {
+    return m_inFlight;
+  }
+
+  const Counters& GetCounters() const {
+    return m_counters;
+  }
+
+  Time GetRtt() const {
+    return m_rtt->GetCurrentEstimate();
+  }
+
+  Time GetRto() const {
+    return m_rtt->RetransmitTimeout();
+  }
+
+  void OnData(shared_ptr<const Data> data) override {
+    if (!m_active) {
+      return;
+    }
+    uint32_t seq = data->getName().at(-1).toSequenceNumber();
+    if (m_seqTimeouts.find(seq) == m_seqTimeouts.end()) {
+      App::OnData(data); // late copy of an interest already answered or given up
+      return;
+    }
+    Consumer::OnData(data);
+
+    m_inFlight = m_inFlight > 0 ? m_inFlight - 1 : 0;
+    m_counters.data++;
+    m_counters.bytes += data->getContent().value_size();
+
+    Grow();
+    ScheduleNextPacket();
+  }
+
+  void OnNack(shared_ptr<const lp::Nack> nack) override {
+    if (!m_active) {
+      return;
+    }
+    Consumer::OnNack(nack);
+
+    uint32_t seq = nack->getInterest().getName().at(-1).toSequenceNumber();
+    if (m_seqTimeouts.erase(seq) == 0) {
+      return;
+    }
+    m_inFlight = m_inFlight > 0 ? m_inFlight - 1 : 0;
+    m_counters.nacks++;
+    Decrease(seq);
+
+    m_retxSeqs.insert(seq);
+    ScheduleNextPacket();
+  }
+
+  void OnTimeout(uint32_t seq) override {
+    m_inFlight = m_inFlight > 0 ? m_inFlight - 1 : 0;
+    m_counters.timeouts++;
+    Decrease(seq);
+    Consumer::OnTimeout(seq); // queues the retransmission
+  }
+
+protected:
+  void StartApplication() override {
+    m_window = m_initialWindow;
+    m_ssthresh = m_initialSsthresh;
+    m_inFlight = 0;
+    m_wMax = 0;
+    m_recoverySeq = 0;
+    m_lastDecrease = Simulator::Now();
+    Consumer::StartApplication();
+  }
+
+  void ScheduleNextPacket() override {
+    if (m_inFlight >= static_cast<uint32_t>(m_window) || m_sendEvent.IsRunning()) {
+      return;
+    }
+    if (m_retxSeqs.empty() && m_seqMax != std::numeric_limits<uint32_t>::max() && m_seq >= m_seqMax) {
+      return; // nothing left to fetch
+    }
+    m_sendEvent = Simulator::Schedule(Seconds(0.0), &Consumer::SendPacket, this);
+  }
+
+  void WillSendOutInterest(uint32_t seq) override {
+    Consumer::WillSendOutInterest(seq);
+    m_inFlight++;
+    m_counters.interests++;
+    if (m_seqRetxCounts[seq] > 1) {
+      m_counters.retransmissions++;
+    }
+  }
+
+  void Grow() {
+    if (m_window < m_ssthresh) {
+      m_window += 1.0;
+    }
+    else if (!m_cubic) {
+      m_window += 1.0 / m_window;
+    }
+    else {
+      // target one RTT ahead, as in RFC 8312
+      double t = (Simulator::Now() - m_lastDecrease + m_rtt->GetCurrentEstimate()).GetSeconds();
+      double k = std::cbrt(m_wMax * (1.0 - m_cubicBeta) / m_cubicC);
+      double target = m_cubicC * std::pow(t - k, 3) + m_wMax;
+      m_window += target > m_window ? (target - m_window) / m_window : 0.01 / m_window;
+    }
+    m_windowTrace(this, m_window, m_inFlight);
+  }
+
+  void Decrease(uint32_t seq) {
+    if (seq < m_recoverySeq) {
+      return; // already reacted to this window
+    }
+    m_recoverySeq = m_seq;
+    m_lastDecrease = Simulator::Now();
+
+    if (!m_cubic) {
+      m_ssthresh = std::max(2.0, m_window * m_beta);
+      m_window = m_ssthresh;
+    }
+    else {
+      m_wMax = m_window;
+      m_window = std::max(1.0, m_window * m_cubicBeta);
+      m_ssthresh = std::max(2.0, m_window);
+    }
+    m_windowTrace(this, m_window, m_inFlight);
+  }
+
+  void SetAlgorithm(std::string algorithm) {
+    if (algorithm != "aimd" && algorithm != "cubic") {
+      NS_FATAL_ERROR("Unknown window algorithm " << algorithm << " (aimd or cubic)");
+    }
+    m_cubic = algorithm == "cubic";
+  }
+
+  std::string GetAlgorithm() const {
+    return m_cubic ? "cubic" : "aimd";
+  }
+
+protected:
+  bool m_cubic;
+  double m_initialWindow;
+  double m_initialSsthresh;
+  double m_beta;
+  double m_cubicBeta;
+  double m_cubicC;
+
+  double m_window;
+  double m_ssthresh;
+  uint32_t m_inFlight;
+  double m_wMax;
+  uint32_t m_recoverySeq; // first sequence number sent after the last decrease
+  Time m_lastDecrease;
+
+  Counters m_counters;
+  TracedCallback<Ptr<App>, double, uint32_t> m_windowTrace;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ConsumerAimd);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_CONSUMER_AIMD_HPP
@@ -0,0 +1,347 @@
+#ifndef NDNSIM_SCRATCH_NDN_CONSUMER_FLOW_GROUP_HPP
+#define NDNSIM_SCRATCH_NDN_CONSUMER_FLOW_GROUP_HPP
+
+#include "ns3/double.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/traced-callback.h"
+#include "ns3/uinteger.h"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief One application simulating many logical consumer flows over a single app face
+ *
+ * Every flow has its own prefix, rate and start/stop times and requests
+ * <prefix>/<sequence number> like ConsumerCbr. All flows share the app face, the nonce
+ * generator and two simulator events: the next send of the earliest flow (from a heap of
+ * (time, flow)) and the expiry of the oldest pending interest (interests all have the
+ * same LifeTime, so pending interests expire in send order).
+ *
+ * Flows are added with AddFlow before the application starts; if none were added, Flows
+ * flows are generated from the attributes: flow i requests <Prefix>/<i> at Frequency,
+ * starting at a uniform offset in [0, StartSpread) after the application.
+ *
+ * Timed out interests are counted, not retransmitted. Per flow counts and delays are
+ * kept (sum and max only, so thousands of flows stay cheap) and printed by PrintStats;
+ * the delay of every satisfied interest is also reported through "FlowDelay".
+*/
+class ConsumerFlowGroup : public App {
+public:
+  static TypeId GetTypeId() {
+    static TypeId tid = TypeId("ns3::ndn::ConsumerFlowGroup")
+      .SetGroupName("Ndn")
+      .SetParent<App>()
+      .AddConstructor<ConsumerFlowGroup>()
+      .AddAttribute("Prefix", "Prefix of the generated flows (flow i requests <Prefix>/<i>/<seq>)",
+        StringValue("/"),
+        MakeNameAccessor(&ConsumerFlowGroup::m_prefix),
+        MakeNameChecker())
+      .AddAttribute("Flows", "Number of generated flows when none were added with AddFlow",
+        UintegerValue(1),
+        MakeUintegerAccessor(&ConsumerFlowGroup::m_flowCount),
+        MakeUintegerChecker<uint32_t>())
+      .AddAttribute("Frequency", "Interests a second of every generated flow",
+        DoubleValue(1.0),
+        MakeDoubleAccessor(&ConsumerFlowGroup::m_frequency),
+        MakeDoubleChecker<double>(0.0))
+      .AddAttribute("StartSpread", "Generated flows start uniformly within this time of the application",
+        StringValue("1s"),
+        MakeTimeAccessor(&ConsumerFlowGroup::m_startSpread),
+        MakeTimeChecker())
+      .AddAttribute("Randomize", "Gaps between interests of a flow: none, uniform or exponential",
+        StringValue("none"),
+        MakeStringAccessor(&ConsumerFlowGroup::SetRandomize, &ConsumerFlowGroup::GetRandomize),
+        MakeStringChecker())
+      .AddAttribute("LifeTime", "LifeTime for interest packet",
+        StringValue("2s"),
+        MakeTimeAccessor(&ConsumerFlowGroup::m_interestLifeTime),
+        MakeTimeChecker())
+      .AddTraceSource("FlowDelay", "Delay between interest and data of a flow",
+        MakeTraceSourceAccessor(&ConsumerFlowGroup::m_flowDelay),
+        "ns3::ndn::ConsumerFlowGroup::FlowDelayCallback");
+    return tid;
+  }
+
+  typedef void (*FlowDelayCallback)(Ptr<App>, uint32_t, Time);
+
+  struct FlowStats {
+    uint64_t sent = 0;
+    uint64_t satisfied = 0;
+    uint64_t timedOut = 0;
+    Time delaySum;
+    Time delayMax;
+  };
+
+  ConsumerFlowGroup()
+    : m_rand(CreateObject<UniformRandomVariable>())
+    , m_exponential(CreateObject<ExponentialRandomVariable>())
+    , m_flowCount(1)
+    , m_frequency(1.0)
+    , m_randomize(NONE) {
+  }
+
+  /**
+   * \brief Add a flow of rate interests a second, running from start to stop (relative to
+   * the application start; zero stop runs until the application stops)
+   * \returns the flow index
+  */
+  uint32_t AddFlow(const Name& prefix, double rate, Time start = Time(0), Time stop = Time(0)) {
+    m_flows.push_back(Flow{ prefix, rate, start, stop, 0, FlowStats() });
+    return static_cast<uint32_t>(m_flows.size() - 1);
+  }
+
+  uint32_t GetNFlows() const {
+    return static_cast<uint32_t>(m_flows.size());
+  }
+
+  const Name& GetFlowPrefix(uint32_t flow) const {
+    return m_flows.at(flow).prefix;
+  }
+
+  const FlowStats& GetFlowStats(uint32_t flow) const {
+    return m_flows.at(flow).stats;
+  }
+
+  void OnData(shared_ptr<const Data> data) override {
+    if (!m_active) {
+      return;
+    }
+    App::OnData(data);
+
+    auto pending = m_pending.find(data->getName());
+    if (pending == m_pending.end()) {
+      return;
+    }
+    FlowStats& stats = m_flows[pending->second.flow].stats;
+    Time delay = Simulator::Now() - pending->second.sent;
+    stats.satisfied++;
+    stats.delaySum += delay;
+    stats.delayMax = std::max(stats.delayMax, delay);
+    m_flowDelay(this, pending->second.flow, delay);
+    m_pending.erase(pending);
+  }
+
+  /**
+   *     Flow Prefix Sent Satisfied TimedOut MeanDelayMs MaxDelayMs
+  */
+  void Print(std::ostream& os, const std::string& prefix = "") const {
+    for (std::size_t i = 0; i < m_flows.size(); i++) {
+      const FlowStats& stats = m_flows[i].stats;
+      os << prefix << i << "\t" << m_flows[i].prefix << "\t" << stats.sent << "\t" << stats.satisfied << "\t"
+         << stats.timedOut << "\t"
+         << (stats.satisfied > 0 ? stats.delaySum.ToDouble(Time::MS) / stats.satisfied : 0) << "\t"
+         << stats.delayMax.ToDouble(Time::MS) << "\n";
+    }
+  }
+
+  /**
+   *     Node AppId Flow Prefix Sent Satisfied TimedOut MeanDelayMs MaxDelayMs
+   *
+   * for every ConsumerFlowGroup of every node.
+  */
+  static void PrintStats(std::ostream& os) {
+    os << "Node" << "\t" << "AppId" << "\t" << "Flow" << "\t" << "Prefix" << "\t" << "Sent" << "\t" << "Satisfied"
+       << "\t" << "TimedOut" << "\t" << "MeanDelayMs" << "\t" << "MaxDelayMs" << "\n";
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      for (uint32_t i = 0; i < (*node)->GetNApplications(); i++) {
+        Ptr<ConsumerFlowGroup> app = DynamicCast<ConsumerFlowGroup>((*node)->GetApplication(i));
+        if (app != 0) {
+          app->Print(os, std::to_string((*node)->GetId()) + "\t" + std::to_string(app->GetId()) + "\t");
+        }
+      }
+    }
+  }
+
+protected:
+  enum Randomize { NONE, UNIFORM, EXPONENTIAL };
+
+  struct Flow {
+    Name prefix;
+    double rate;
+    Time start;
+    Time stop;
+    uint32_t seq;
+    FlowStats stats;
+  };
+
+  struct Pending {
+    uint32_t flow;
+    Time sent;
+  };
+
+  typedef std::pair<Time, uint32_t> Scheduled; // next send time, flow
+
+  void StartApplication() override {
+    App::StartApplication();
+
+    if (m_flows.empty()) {
+      for (uint32_t i = 0; i < m_flowCount; i++) {
+        Time start = m_startSpread.IsPositive() ? Seconds(m_rand->GetValue(0, m_startSpread.GetSeconds())) : Time(0);
+        AddFlow(Name(m_prefix).appendNumber(i), m_frequency, start);
+      }
+    }
+
+    Time now = Simulator::Now();
+    m_started = now;
+    m_queue = std::priority_queue<Scheduled, std::vector<Scheduled>, std::greater<Scheduled>>();
+    for (uint32_t i = 0; i < m_flows.size(); i++) {
+      if (m_flows[i].rate > 0) {
+        m_queue.emplace(now + m_flows[i].start, i);
+      }
+    }
+    ScheduleNext();
+  }
+
+  void StopApplication() override {
+    Simulator::Cancel(m_sendEvent);
+    Simulator::Cancel(m_expiryEvent);
+    App::StopApplication();
+  }
+
+  void ScheduleNext() {
+    if (!m_queue.empty()) {
+      m_sendEvent = Simulator::Schedule(m_queue.top().first - Simulator::Now(), &ConsumerFlowGroup::SendDue, this);
+    }
+  }
+
+  /**
+   * \brief Send the interests of every flow due now and reschedule those flows
+  */
+  void SendDue() {
+    Time now = Simulator::Now();
+    while (!m_queue.empty() && m_queue.top().first <= now) {
+      uint32_t index = m_queue.top().second;
+      m_queue.pop();
+
+      Flow& flow = m_flows[index];
+      if (!flow.stop.IsZero() && now >= m_started + flow.stop) {
+        continue; // flow finished
+      }
+      SendInterest(index);
+      m_queue.emplace(now + Gap(flow.rate), index);
+    }
+    ScheduleNext();
+  }
+
+  void SendInterest(uint32_t index) {
+    if (!m_active) {
+      return;
+    }
+    Flow& flow = m_flows[index];
+    shared_ptr<Name> name = make_shared<Name>(flow.prefix);
+    name->appendSequenceNumber(flow.seq++);
+
+    shared_ptr<Interest> interest = make_shared<Interest>(*name);
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setInterestLifetime(time::milliseconds(m_interestLifeTime.GetMilliSeconds()));
+
+    Time now = Simulator::Now();
+    m_pending[interest->getName()] = Pending{ index, now };
+    m_expiry.emplace_back(now, interest->getName());
+    if (!m_expiryEvent.IsRunning()) {
+      m_expiryEvent = Simulator::Schedule(m_interestLifeTime, &ConsumerFlowGroup::ExpirePending, this);
+    }
+    flow.stats.sent++;
+
+    m_transmittedInterests(interest, this, m_face);
+    m_appLink->onReceiveInterest(*interest);
+  }
+
+  Time Gap(double rate) {
+    double mean = 1.0 / rate;
+    switch (m_randomize) {
+    case UNIFORM:
+      return Seconds(m_rand->GetValue(0, 2 * mean));
+    case EXPONENTIAL:
+      return Seconds(m_exponential->GetValue(mean, 50 * mean));
+    default:
+      return Seconds(mean);
+    }
+  }
+
+  /**
+   * \brief Count pending interests older than LifeTime as timed out; entries are in send order
+  */
+  void ExpirePending() {
+    Time deadline = Simulator::Now() - m_interestLifeTime;
+    while (!m_expiry.empty() && m_expiry.front().first <= deadline) {
+      auto pending = m_pending.find(m_expiry.front().second);
+      if (pending != m_pending.end() && pending->second.sent == m_expiry.front().first) {
+        m_flows[pending->second.flow].stats.timedOut++;
+        m_pending.erase(pending);
+      }
+      m_expiry.pop_front();
+    }
+    if (!m_expiry.empty()) {
+      m_expiryEvent = Simulator::Schedule(m_expiry.front().first + m_interestLifeTime - Simulator::Now(),
+        &ConsumerFlowGroup::ExpirePending, this);
+    }
+  }
+
+  void SetRandomize(std::string value) {
+    if (value == "uniform") {
+      m_randomize = UNIFORM;
+    }
+    else if (value == "exponential") {
+      m_randomize = EXPONENTIAL;
+    }
+    else if (value == "none") {
+      m_randomize = NONE;
+    }
+    else {
+      NS_FATAL_ERROR("Unknown Randomize " << value << " (none, uniform or exponential)");
+    }
+  }
+
+  std::string GetRandomize() const {
+    return m_randomize == UNIFORM ? "uniform" : m_randomize == EXPONENTIAL ? "exponential" : "none";
+  }
+
+protected:
+  Ptr<UniformRandomVariable> m_rand;
+  Ptr<ExponentialRandomVariable> m_exponential;
+
+  Name m_prefix;
+  uint32_t m_flowCount;
+  double m_frequency;
+  Time m_startSpread;
+  Randomize m_randomize;
+  Time m_interestLifeTime;
+
+  std::vector<Flow> m_flows;
+  Time m_started;
+  std::priority_queue<Scheduled, std::vector<Scheduled>, std::greater<Scheduled>> m_queue;
+  EventId m_sendEvent;
+
+  std::unordered_map<Name, Pending> m_pending;
+  std::deque<std::pair<Time, Name>> m_expiry;
+  EventId m_expiryEvent;
+
+  TracedCallback<Ptr<App>, uint32_t, Time> m_flowDelay;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ConsumerFlowGroup);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_CONSUMER_FLOW_GROUP_HPP
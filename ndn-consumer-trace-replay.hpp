@@ -0,0 +1,345 @@
+#ifndef NDNSIM_SCRATCH_NDN_CONSUMER_TRACE_REPLAY_HPP
+#define NDNSIM_SCRATCH_NDN_CONSUMER_TRACE_REPLAY_HPP
+
+#include "ns3/names.h"
+#include "ns3/node.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+class ConsumerTraceReplay;
+
+/**
+ * \brief Streams request records from a trace file shared by all replay consumers
+ *
+ * Trace format, one record per line, sorted by time ('#' starts a comment):
+ *
+ *     <seconds> <node-id or node name> <interest name>
+ *
+ * Only one chunk of ChunkSize records is kept in memory and the reader has exactly one
+ * pending simulator event: at the time of the next record it hands every record due at
+ * that time to the consumer registered for its node, then schedules itself for the
+ * following record (reading the next chunk when the current one is used up).
+ *
+ * Records for nodes without a running consumer and records already in the past when a
+ * consumer (re)starts are skipped and counted.
+*/
+class RequestTraceReader : public SimpleRefCount<RequestTraceReader> {
+public:
+  /**
+   * \brief Reader for the given file, shared by all consumers replaying it
+  */
+  static Ptr<RequestTraceReader> Get(const std::string& file, size_t chunkSize) {
+    static std::map<std::string, Ptr<RequestTraceReader>> readers;
+    Ptr<RequestTraceReader>& reader = readers[file];
+    if (reader == 0) {
+      reader = Create<RequestTraceReader>(file, chunkSize);
+    }
+    return reader;
+  }
+
+  RequestTraceReader(const std::string& file, size_t chunkSize)
+    : m_fileName(file)
+    , m_file(file.c_str())
+    , m_chunkSize(chunkSize > 0 ? chunkSize : 1)
+    , m_next(0)
+    , m_lineNo(0)
+    , m_skipped(0)
+    , m_dispatched(0) {
+    if (!m_file.is_open()) {
+      NS_FATAL_ERROR("Request trace " << file << " cannot be opened");
+    }
+  }
+
+  void Register(uint32_t nodeId, ConsumerTraceReplay* app) {
+    m_apps[nodeId] = app;
+    if (!m_event.IsRunning()) {
+      ScheduleNext();
+    }
+  }
+
+  void Unregister(uint32_t nodeId) {
+    m_apps.erase(nodeId);
+    if (m_apps.empty()) {
+      Simulator::Cancel(m_event);
+    }
+  }
+
+  uint64_t GetDispatched() const {
+    return m_dispatched;
+  }
+
+  uint64_t GetSkipped() const {
+    return m_skipped;
+  }
+
+private:
+  struct Record {
+    Time time;
+    uint32_t node;
+    std::string name;
+  };
+
+  bool ReadChunk() {
+    m_chunk.clear();
+    m_next = 0;
+
+    std::string line;
+    while (m_chunk.size() < m_chunkSize && std::getline(m_file, line)) {
+      m_lineNo++;
+      if (line.empty() || line[0] == '#') {
+        continue;
+      }
+
+      char* end = nullptr;
+      double seconds = std::strtod(line.c_str(), &end);
+      size_t nodeStart = line.find_first_not_of(" \t", end - line.c_str());
+      size_t nodeEnd = line.find_first_of(" \t", nodeStart);
+      size_t nameStart = line.find_first_not_of(" \t", nodeEnd);
+      if (end == line.c_str() || nameStart == std::string::npos) {
+        NS_FATAL_ERROR(m_fileName << ":" << m_lineNo << ": expected <time> <node> <name>");
+      }
+
+      size_t nameEnd = line.find_first_of(" \t\r", nameStart);
+      m_chunk.push_back(Record{ Seconds(seconds),
+                                ResolveNode(line.substr(nodeStart, nodeEnd - nodeStart)),
+                                line.substr(nameStart, nameEnd == std::string::npos ? nameEnd : nameEnd - nameStart) });
+    }
+    return !m_chunk.empty();
+  }
+
+  uint32_t ResolveNode(const std::string& token) {
+    char* end = nullptr;
+    unsigned long id = std::strtoul(token.c_str(), &end, 10);
+    if (*end == '\0') {
+      return static_cast<uint32_t>(id);
+    }
+
+    auto it = m_nodeIds.find(token);
+    if (it == m_nodeIds.end()) {
+      Ptr<Node> node = Names::Find<Node>(token);
+      if (node == 0) {
+        NS_FATAL_ERROR(m_fileName << ":" << m_lineNo << ": unknown node " << token);
+      }
+      it = m_nodeIds.emplace(token, node->GetId()).first;
+    }
+    return it->second;
+  }
+
+  /**
+   * \brief Skip past records and schedule the event for the next due record
+  */
+  void ScheduleNext() {
+    Time now = Simulator::Now();
+    while (true) {
+      if (m_next >= m_chunk.size() && !ReadChunk()) {
+        return; // end of trace
+      }
+      if (m_chunk[m_next].time >= now) {
+        break;
+      }
+      m_skipped++;
+      m_next++;
+    }
+    m_event = Simulator::Schedule(m_chunk[m_next].time - now, &RequestTraceReader::Dispatch, this);
+  }
+
+  void Dispatch();
+
+private:
+  std::string m_fileName;
+  std::ifstream m_file;
+  size_t m_chunkSize;
+  std::vector<Record> m_chunk;
+  size_t m_next;
+  uint64_t m_lineNo;
+  EventId m_event;
+
+  std::unordered_map<uint32_t, ConsumerTraceReplay*> m_apps;
+  std::unordered_map<std::string, uint32_t> m_nodeIds;
+
+  uint64_t m_skipped;
+  uint64_t m_dispatched;
+};
+
+/**
+ * \brief Consumer that expresses the interests of a request trace for its node
+ *
+ * All consumers with the same TraceFile share one RequestTraceReader. Satisfied,
+ * timed out and sent interests are counted per consumer; the delay of every satisfied
+ * interest is reported through the "ReplayDelay" trace source.
+*/
+class ConsumerTraceReplay : public App {
+public:
+  static TypeId GetTypeId() {
+    static TypeId tid = TypeId("ns3::ndn::ConsumerTraceReplay")
+      .SetGroupName("Ndn")
+      .SetParent<App>()
+      .AddConstructor<ConsumerTraceReplay>()
+      .AddAttribute("TraceFile", "Request trace with <time> <node> <name> records",
+        StringValue(""),
+        MakeStringAccessor(&ConsumerTraceReplay::m_traceFile),
+        MakeStringChecker())
+      .AddAttribute("ChunkSize", "Records kept in memory by the shared reader",
+        UintegerValue(4096),
+        MakeUintegerAccessor(&ConsumerTraceReplay::m_chunkSize),
+        MakeUintegerChecker<uint32_t>())
+      .AddAttribute("LifeTime", "LifeTime for interest packet",
+        StringValue("2s"),
+        MakeTimeAccessor(&ConsumerTraceReplay::m_interestLifeTime),
+        MakeTimeChecker())
+      .AddTraceSource("ReplayDelay", "Delay between interest and data of a replayed request",
+        MakeTraceSourceAccessor(&ConsumerTraceReplay::m_replayDelay),
+        "ns3::ndn::ConsumerTraceReplay::ReplayDelayCallback");
+    return tid;
+  }
+
+  typedef void (*ReplayDelayCallback)(Ptr<App>, const Name&, Time);
+
+  ConsumerTraceReplay()
+    : m_rand(CreateObject<UniformRandomVariable>())
+    , m_chunkSize(4096)
+    , m_sent(0)
+    , m_satisfied(0)
+    , m_timedOut(0) {
+  }
+
+  /**
+   * \brief Express an interest for the given name now (called by the shared reader)
+  */
+  void SendInterest(const std::string& uri) {
+    if (!m_active) {
+      return;
+    }
+
+    shared_ptr<Interest> interest = make_shared<Interest>(Name(uri));
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setInterestLifetime(time::milliseconds(m_interestLifeTime.GetMilliSeconds()));
+
+    Time now = Simulator::Now();
+    if (m_pending.emplace(interest->getName(), now).second) {
+      m_expiry.emplace_back(now, interest->getName());
+      if (!m_expiryEvent.IsRunning()) {
+        m_expiryEvent = Simulator::Schedule(m_interestLifeTime, &ConsumerTraceReplay::ExpirePending, this);
+      }
+    }
+    m_sent++;
+
+    m_transmittedInterests(interest, this, m_face);
+    m_appLink->onReceiveInterest(*interest);
+  }
+
+  void OnData(shared_ptr<const Data> data) override {
+    if (!m_active) {
+      return;
+    }
+    App::OnData(data);
+
+    auto it = m_pending.find(data->getName());
+    if (it != m_pending.end()) {
+      m_satisfied++;
+      m_replayDelay(this, it->first, Simulator::Now() - it->second);
+      m_pending.erase(it);
+    }
+  }
+
+  uint64_t GetSent() const { return m_sent; }
+  uint64_t GetSatisfied() const { return m_satisfied; }
+  uint64_t GetTimedOut() const { return m_timedOut; }
+
+protected:
+  void StartApplication() override {
+    App::StartApplication();
+    m_reader = RequestTraceReader::Get(m_traceFile, m_chunkSize);
+    m_reader->Register(GetNode()->GetId(), this);
+  }
+
+  void StopApplication() override {
+    if (m_reader != 0) {
+      m_reader->Unregister(GetNode()->GetId());
+    }
+    Simulator::Cancel(m_expiryEvent);
+    App::StopApplication();
+  }
+
+private:
+  /**
+   * \brief Drop pending requests older than LifeTime; entries are in send order
+  */
+  void ExpirePending() {
+    Time deadline = Simulator::Now() - m_interestLifeTime;
+    while (!m_expiry.empty() && m_expiry.front().first <= deadline) {
+      auto it = m_pending.find(m_expiry.front().second);
+      if (it != m_pending.end() && it->second == m_expiry.front().first) {
+        m_timedOut++;
+        m_pending.erase(it);
+      }
+      m_expiry.pop_front();
+    }
+    if (!m_expiry.empty()) {
+      m_expiryEvent = Simulator::Schedule(m_expiry.front().first + m_interestLifeTime - Simulator::Now(),
+        &ConsumerTraceReplay::ExpirePending, this);
+    }
+  }
+
+private:
+  Ptr<UniformRandomVariable> m_rand;
+  std::string m_traceFile;
+  uint32_t m_chunkSize;
+  Time m_interestLifeTime;
+  Ptr<RequestTraceReader> m_reader;
+
+  std::map<Name, Time> m_pending;
+  std::deque<std::pair<Time, Name>> m_expiry;
+  EventId m_expiryEvent;
+
+  uint64_t m_sent;
+  uint64_t m_satisfied;
+  uint64_t m_timedOut;
+  TracedCallback<Ptr<App>, const Name&, Time> m_replayDelay;
+};
+
+inline void RequestTraceReader::Dispatch() {
+  Time now = Simulator::Now();
+  while (m_next < m_chunk.size() && m_chunk[m_next].time <= now) {
+    const Record& record = m_chunk[m_next++];
+    auto app = m_apps.find(record.node);
+    if (app != m_apps.end()) {
+      app->second->SendInterest(record.name);
+      m_dispatched++;
+    }
+    else {
+      m_skipped++;
+    }
+    if (m_next >= m_chunk.size() && !ReadChunk()) {
+      return; // end of trace
+    }
+  }
+  ScheduleNext();
+}
+
+NS_OBJECT_ENSURE_REGISTERED(ConsumerTraceReplay);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_CONSUMER_TRACE_REPLAY_HPP
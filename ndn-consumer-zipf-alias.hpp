@@ -0,0 +1,217 @@
+#ifndef NDNSIM_SCRATCH_NDN_CONSUMER_ZIPF_ALIAS_HPP
+#define NDNSIM_SCRATCH_NDN_CONSUMER_ZIPF_ALIAS_HPP
+
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ndnSIM/apps/ndn-consumer-cbr.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Walker/Vose alias table over Zipf-Mandelbrot ranks 1..N, p(k) ~ 1 / (k + q)^s
+ *
+ * Built once in O(N); Sample() is O(1) and needs two uniform draws. The acceptance
+ * threshold of every column is stored as a 32-bit fraction, so a table costs 8 bytes
+ * per content (80 MB for 10M contents) and is shared by all consumers with the same
+ * (N, q, s), see Get().
+*/
+class ZipfAliasTable {
+public:
+  ZipfAliasTable(uint32_t n, double q, double s)
+    : m_threshold(n)
+    , m_alias(n) {
+    std::vector<double> scaled(n);
+    double sum = 0;
+    for (uint32_t k = 0; k < n; k++) {
+      scaled[k] = 1.0 / std::pow(k + 1 + q, s);
+      sum += scaled[k];
+    }
+
+    std::vector<uint32_t> small, large;
+    for (uint32_t k = 0; k < n; k++) {
+      scaled[k] *= n / sum;
+      (scaled[k] < 1.0 ? small : large).push_back(k);
+    }
+
+    while (!small.empty() && !large.empty()) {
+      uint32_t l = small.back();
+      uint32_t g = large.back();
+      small.pop_back();
+
+      m_threshold[l] = ToThreshold(scaled[l]);
+      m_alias[l] = g;
+
+      scaled[g] -= 1.0 - scaled[l];
+      if (scaled[g] < 1.0) {
+        large.pop_back();
+        small.push_back(g);
+      }
+    }
+    // leftovers are 1.0 up to rounding
+    for (uint32_t k : large) {
+      m_threshold[k] = std::numeric_limits<uint32_t>::max();
+      m_alias[k] = k;
+    }
+    for (uint32_t k : small) {
+      m_threshold[k] = std::numeric_limits<uint32_t>::max();
+      m_alias[k] = k;
+    }
+  }
+
+  /**
+   * \brief Table for the given parameters, shared while any consumer holds it
+  */
+  static std::shared_ptr<const ZipfAliasTable> Get(uint32_t n, double q, double s) {
+    static std::map<std::tuple<uint32_t, double, double>, std::weak_ptr<const ZipfAliasTable>> tables;
+
+    std::weak_ptr<const ZipfAliasTable>& cached = tables[std::make_tuple(n, q, s)];
+    std::shared_ptr<const ZipfAliasTable> table = cached.lock();
+    if (table == nullptr) {
+      table = std::make_shared<const ZipfAliasTable>(n, q, s);
+      cached = table;
+    }
+    return table;
+  }
+
+  /**
+   * \brief Rank in [1, N]
+   * \param column uniform integer in [0, N)
+   * \param coin uniform 32-bit integer
+  */
+  uint32_t Sample(uint32_t column, uint32_t coin) const {
+    return (coin < m_threshold[column] ? column : m_alias[column]) + 1;
+  }
+
+  uint32_t GetN() const {
+    return m_alias.size();
+  }
+
+private:
+  static uint32_t ToThreshold(double p) {
+    return p >= 1.0 ? std::numeric_limits<uint32_t>::max()
+                    : static_cast<uint32_t>(p * 4294967296.0);
+  }
+
+private:
+  std::vector<uint32_t> m_threshold;
+  std::vector<uint32_t> m_alias;
+};
+
+/**
+ * \brief ConsumerCbr requesting Zipf-Mandelbrot distributed sequence numbers in O(1)
+ *
+ * Same attributes as ConsumerZipfMandelbrot (NumberOfContents, q, s) but the rank is
+ * drawn from a shared alias table instead of a linear search over the CDF.
+*/
+class ConsumerZipfAlias : public ConsumerCbr {
+public:
+  static TypeId GetTypeId() {
+    static TypeId tid = TypeId("ns3::ndn::ConsumerZipfAlias")
+      .SetGroupName("Ndn")
+      .SetParent<ConsumerCbr>()
+      .AddConstructor<ConsumerZipfAlias>()
+      .AddAttribute("NumberOfContents", "Number of contents in the catalog",
+        UintegerValue(100),
+        MakeUintegerAccessor(&ConsumerZipfAlias::m_n),
+        MakeUintegerChecker<uint32_t>(1))
+      .AddAttribute("q", "Parameter q of the Zipf-Mandelbrot distribution",
+        DoubleValue(0.7),
+        MakeDoubleAccessor(&ConsumerZipfAlias::m_q),
+        MakeDoubleChecker<double>())
+      .AddAttribute("s", "Parameter s of the Zipf-Mandelbrot distribution",
+        DoubleValue(0.7),
+        MakeDoubleAccessor(&ConsumerZipfAlias::m_s),
+        MakeDoubleChecker<double>());
+    return tid;
+  }
+
+  ConsumerZipfAlias()
+    : m_n(100)
+    , m_q(0.7)
+    , m_s(0.7)
+    , m_uniform(CreateObject<UniformRandomVariable>()) {
+  }
+
+  void SendPacket() {
+    if (!m_active) {
+      return;
+    }
+
+    uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
+
+    if (!m_retxSeqs.empty()) {
+      seq = *m_retxSeqs.begin();
+      m_retxSeqs.erase(m_retxSeqs.begin());
+    }
+    else {
+      if (m_seqMax != std::numeric_limits<uint32_t>::max() && m_seq >= m_seqMax) {
+        return; // we are totally done
+      }
+      seq = m_table->Sample(m_uniform->GetInteger(0, m_table->GetN() - 1),
+                            m_uniform->GetInteger(0, std::numeric_limits<uint32_t>::max()));
+      m_seq++;
+    }
+
+    shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
+    nameWithSequence->appendSequenceNumber(seq);
+
+    shared_ptr<Interest> interest = make_shared<Interest>();
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setName(*nameWithSequence);
+    interest->setInterestLifetime(time::milliseconds(m_interestLifeTime.GetMilliSeconds()));
+
+    WillSendOutInterest(seq);
+
+    m_transmittedInterests(interest, this, m_face);
+    m_appLink->onReceiveInterest(*interest);
+
+    ScheduleNextPacket();
+  }
+
+protected:
+  void StartApplication() override {
+    m_table = ZipfAliasTable::Get(m_n, m_q, m_s);
+    ConsumerCbr::StartApplication();
+  }
+
+  void StopApplication() override {
+    ConsumerCbr::StopApplication();
+    m_table.reset();
+  }
+
+  void ScheduleNextPacket() override {
+    if (m_firstTime) {
+      m_sendEvent = Simulator::Schedule(Seconds(0.0), &ConsumerZipfAlias::SendPacket, this);
+      m_firstTime = false;
+    }
+    else if (!m_sendEvent.IsRunning()) {
+      m_sendEvent = Simulator::Schedule((m_random == 0) ? Seconds(1.0 / m_frequency) : Seconds(m_random->GetValue()),
+        &ConsumerZipfAlias::SendPacket, this);
+    }
+  }
+
+private:
+  uint32_t m_n;
+  double m_q;
+  double m_s;
+  Ptr<UniformRandomVariable> m_uniform;
+  std::shared_ptr<const ZipfAliasTable> m_table;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(ConsumerZipfAlias);
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_CONSUMER_ZIPF_ALIAS_HPP
@@ -0,0 +1,317 @@
+#ifndef NDNSIM_SCRATCH_NDN_DIRECT_LINK_HPP
+#define NDNSIM_SCRATCH_NDN_DIRECT_LINK_HPP
+
+#include "ns3/mac48-address.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/ptr.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/model/ndn-net-device-transport.hpp"
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+#include "ns3/ndnSIM/NFD/daemon/face/link-service.hpp"
+
+#include <ndn-cxx/lp/packet.hpp>
+#include <ndn-cxx/lp/tags.hpp>
+
+#include "ideal-link.hpp"
+
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Link service passing decoded Interest/Data/Nack objects across an IdealNetDevice link
+ *
+ * GenericLinkService encodes every packet into an LpPacket, wraps it in an ns3::Packet
+ * and the next node parses it again, although only hop-local tags change. When both
+ * ends of an IdealChannel use this service, the sender reserves the transmitter for the
+ * exact number of bytes GenericLinkService would have sent (LpPacket with HopCountTag
+ * around the wire encoding, so serialization timing and backlog drops are unchanged) and
+ * schedules the delivery of the packet object itself on the peer node.
+ *
+ * The receiver takes a shallow copy (name components and the cached wire encoding are
+ * shared, nothing is parsed), drops the face-scoped tags of the sender and increments the
+ * hop count, the same tags GenericLinkService would have carried over.
+ *
+ * Bytes are produced only when they are needed: an Interest created by an app is encoded
+ * once at its first hop (its size is needed) and the cached encoding is reused on later
+ * hops, and a peer that does not use this service gets a regular LpPacket through the
+ * NetDeviceTransport. Passed-through packets do not show in the device's MacTx/MacRx
+ * traces nor in the face byte counters; the packet counters and every L3 trace are
+ * unaffected. A scenario that reads those (e.g. ShmMetricsExporter's l2TxBytes and
+ * nOutBytes) calls SetBytesNeeded(true), and every packet is then sent as bytes.
+*/
+class DirectLinkService : public nfd::face::LinkService {
+public:
+  struct Counters {
+    uint64_t direct = 0;  // packets passed as objects
+    uint64_t encoded = 0; // packets sent as bytes (peer without DirectLinkService)
+    uint64_t dropped = 0; // backlog full or link down
+  };
+
+  explicit DirectLinkService(Ptr<NetDevice> device)
+    : m_device(device) {
+    Services()[PeekPointer(m_device)] = this;
+  }
+
+  ~DirectLinkService() override {
+    auto self = Services().find(PeekPointer(m_device));
+    if (self != Services().end() && self->second == this) {
+      Services().erase(self);
+    }
+  }
+
+  static Counters& GetCounters() {
+    static Counters counters;
+    return counters;
+  }
+
+  /**
+   * \brief Send every packet as bytes, for device traces and face byte counters
+  */
+  static void SetBytesNeeded(bool needed) {
+    BytesNeeded() = needed;
+  }
+
+private:
+  /**
+   * \brief What travels in place of the bytes
+  */
+  struct Frame {
+    shared_ptr<const Interest> interest;
+    shared_ptr<const Data> data;
+    lp::NackHeader nack; // with interest, when nack is set
+    bool isNack;
+    uint64_t hopCount;
+  };
+
+  static bool& BytesNeeded() {
+    static bool needed = false;
+    return needed;
+  }
+
+  static std::unordered_map<const NetDevice*, DirectLinkService*>& Services() {
+    static std::unordered_map<const NetDevice*, DirectLinkService*> services;
+    return services;
+  }
+
+  /**
+   * \brief Bytes GenericLinkService puts on the link: LpPacket { HopCountTag, [Nack,] Fragment }
+  */
+  static uint32_t LinkSize(const Block& wire, uint64_t hopCount, const lp::NackHeader* nack) {
+    namespace tlv = ::ndn::tlv;
+    std::size_t hopValue = tlv::sizeOfNonNegativeInteger(hopCount);
+    std::size_t inner = tlv::sizeOfVarNumber(lp::tlv::HopCountTag) + tlv::sizeOfVarNumber(hopValue) + hopValue
+                        + tlv::sizeOfVarNumber(lp::tlv::Fragment) + tlv::sizeOfVarNumber(wire.size()) + wire.size();
+    if (nack != nullptr) {
+      inner += nack->wireEncode().size();
+    }
+    return static_cast<uint32_t>(tlv::sizeOfVarNumber(lp::tlv::LpPacket) + tlv::sizeOfVarNumber(inner) + inner);
+  }
+
+  static uint64_t HopCount(const ::ndn::TagHost& packet) {
+    shared_ptr<lp::HopCountTag> tag = packet.getTag<lp::HopCountTag>();
+    return tag != nullptr ? tag->get() : 0;
+  }
+
+  /**
+   * \brief The object itself when it is owned by a shared_ptr, else a copy
+  */
+  template<typename T>
+  static shared_ptr<const T> Share(const T& packet) {
+    shared_ptr<const T> shared = packet.weak_from_this().lock();
+    return shared != nullptr ? shared : make_shared<T>(packet);
+  }
+
+  /**
+   * \brief Peer service to pass the frame to, nullptr to send bytes instead
+  */
+  DirectLinkService* Peer() const {
+    Ptr<IdealNetDevice> device = DynamicCast<IdealNetDevice>(m_device);
+    if (device == 0 || BytesNeeded()) {
+      return nullptr;
+    }
+    auto peer = Services().find(PeekPointer(device->GetPeer()));
+    return peer != Services().end() ? peer->second : nullptr;
+  }
+
+  void doSendInterest(const Interest& interest, const nfd::face::EndpointId&) override {
+    uint64_t hopCount = HopCount(interest);
+    if (Peer() == nullptr) {
+      lp::Packet lpPacket(interest.wireEncode());
+      lpPacket.add<lp::HopCountTagField>(hopCount);
+      SendBytes(lpPacket);
+      return;
+    }
+    SendFrame(Frame{ Share(interest), nullptr, lp::NackHeader(), false, hopCount },
+              LinkSize(interest.wireEncode(), hopCount, nullptr));
+  }
+
+  void doSendData(const Data& data, const nfd::face::EndpointId&) override {
+    uint64_t hopCount = HopCount(data);
+    if (Peer() == nullptr) {
+      lp::Packet lpPacket(data.wireEncode());
+      lpPacket.add<lp::HopCountTagField>(hopCount);
+      SendBytes(lpPacket);
+      return;
+    }
+    SendFrame(Frame{ nullptr, Share(data), lp::NackHeader(), false, hopCount },
+              LinkSize(data.wireEncode(), hopCount, nullptr));
+  }
+
+  void doSendNack(const lp::Nack& nack, const nfd::face::EndpointId&) override {
+    uint64_t hopCount = HopCount(nack);
+    if (Peer() == nullptr) {
+      lp::Packet lpPacket(nack.getInterest().wireEncode());
+      lpPacket.add<lp::NackField>(nack.getHeader());
+      lpPacket.add<lp::HopCountTagField>(hopCount);
+      SendBytes(lpPacket);
+      return;
+    }
+    SendFrame(Frame{ Share(nack.getInterest()), nullptr, nack.getHeader(), true, hopCount },
+              LinkSize(nack.getInterest().wireEncode(), hopCount, &nack.getHeader()));
+  }
+
+  void SendBytes(const lp::Packet& lpPacket) {
+    GetCounters().encoded++;
+    this->sendPacket(lpPacket.wireEncode(), 0);
+  }
+
+  void SendFrame(const Frame& frame, uint32_t bytes) {
+    Ptr<IdealNetDevice> device = StaticCast<IdealNetDevice>(m_device);
+    Time delay = device->IsLinkUp() ? device->ReserveTransmission(bytes) : Time(-1);
+    if (delay.IsNegative()) {
+      GetCounters().dropped++;
+      return;
+    }
+    GetCounters().direct++;
+    Ptr<NetDevice> peer = device->GetPeer();
+    Simulator::ScheduleWithContext(peer->GetNode()->GetId(), delay, &DirectLinkService::Deliver, peer, frame);
+  }
+
+  static void Deliver(Ptr<NetDevice> to, Frame frame) {
+    auto service = Services().find(PeekPointer(to));
+    if (service != Services().end()) {
+      service->second->Receive(frame);
+    }
+  }
+
+  template<typename T>
+  static shared_ptr<T> Arrived(const T& packet, uint64_t hopCount) {
+    shared_ptr<T> copy = make_shared<T>(packet);
+    copy->template removeTag<lp::IncomingFaceIdTag>();
+    copy->template removeTag<lp::NextHopFaceIdTag>();
+    copy->setTag(make_shared<lp::HopCountTag>(hopCount + 1));
+    return copy;
+  }
+
+  void Receive(const Frame& frame) {
+    if (frame.data != nullptr) {
+      this->receiveData(*Arrived(*frame.data, frame.hopCount), 0);
+    }
+    else if (frame.isNack) {
+      lp::Nack nack(*Arrived(*frame.interest, frame.hopCount));
+      nack.setHeader(frame.nack);
+      this->receiveNack(nack, 0);
+    }
+    else {
+      this->receiveInterest(*Arrived(*frame.interest, frame.hopCount), 0);
+    }
+  }
+
+  /**
+   * \brief Bytes from a peer without DirectLinkService (LpPacket or bare network packet)
+  */
+  void doReceivePacket(const Block& packet, const nfd::face::EndpointId& endpoint) override {
+    try {
+      lp::Packet lpPacket(packet);
+      if (!lpPacket.has<lp::FragmentField>()) {
+        return; // idle packet
+      }
+      auto fragment = lpPacket.get<lp::FragmentField>();
+      Block netPacket(&*fragment.first, std::distance(fragment.first, fragment.second));
+      uint64_t hopCount = lpPacket.has<lp::HopCountTagField>() ? lpPacket.get<lp::HopCountTagField>() : 0;
+
+      if (netPacket.type() == ::ndn::tlv::Interest) {
+        auto interest = make_shared<Interest>(netPacket);
+        interest->setTag(make_shared<lp::HopCountTag>(hopCount + 1));
+        if (lpPacket.has<lp::NackField>()) {
+          lp::Nack nack(std::move(*interest));
+          nack.setHeader(lpPacket.get<lp::NackField>());
+          this->receiveNack(nack, endpoint);
+        }
+        else {
+          this->receiveInterest(*interest, endpoint);
+        }
+      }
+      else if (netPacket.type() == ::ndn::tlv::Data) {
+        auto data = make_shared<Data>(netPacket);
+        data->setTag(make_shared<lp::HopCountTag>(hopCount + 1));
+        this->receiveData(*data, endpoint);
+      }
+    }
+    catch (const ::ndn::tlv::Error&) {
+      // malformed packet, dropped like GenericLinkService does
+    }
+  }
+
+private:
+  Ptr<NetDevice> m_device;
+};
+
+/**
+ * \brief Installs DirectLinkService faces on the IdealNetDevice links of a StackHelper
+ *
+ *     ndn::StackHelper ndnHelper;
+ *     ndn::DirectLinkHelper::Install(ndnHelper);
+ *     ndnHelper.InstallAll();
+ *
+ * Must be called before the stack is installed; other devices keep their default faces.
+*/
+class DirectLinkHelper {
+public:
+  static void Install(StackHelper& stackHelper) {
+    stackHelper.AddFaceCreateCallback(IdealNetDevice::GetTypeId(), MakeCallback(&DirectLinkHelper::CreateFace));
+  }
+
+  /**
+   *     Direct Encoded Dropped
+  */
+  static void PrintStats(std::ostream& os) {
+    const DirectLinkService::Counters& counters = DirectLinkService::GetCounters();
+    os << "Direct" << "\t" << "Encoded" << "\t" << "Dropped" << "\n";
+    os << counters.direct << "\t" << counters.encoded << "\t" << counters.dropped << "\n";
+  }
+
+private:
+  static std::string DeviceUri(Ptr<NetDevice> device) {
+    std::ostringstream uri;
+    uri << "netdev://[" << Mac48Address::ConvertFrom(device->GetAddress()) << "]";
+    return uri.str();
+  }
+
+  static shared_ptr<Face> CreateFace(Ptr<Node> node, Ptr<L3Protocol> ndn, Ptr<NetDevice> device) {
+    Ptr<IdealNetDevice> ideal = DynamicCast<IdealNetDevice>(device);
+    auto linkService = std::make_unique<DirectLinkService>(device);
+    auto transport = std::make_unique<NetDeviceTransport>(node, device, DeviceUri(device), DeviceUri(ideal->GetPeer()));
+
+    auto face = std::make_shared<Face>(std::move(linkService), std::move(transport));
+    face->setMetric(1);
+    ndn->addFace(face);
+    return face;
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_DIRECT_LINK_HPP
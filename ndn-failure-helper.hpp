@@ -0,0 +1,256 @@
+#ifndef NDNSIM_SCRATCH_NDN_FAILURE_HELPER_HPP
+#define NDNSIM_SCRATCH_NDN_FAILURE_HELPER_HPP
+
+#include "ns3/application-container.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+#include "ns3/ndnSIM/helper/ndn-link-control-helper.hpp"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/model/ndn-net-device-transport.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Schedules link and node failures and measures how consumers recover from them
+ *
+ * Links are taken down and up with LinkControlHelper (error rate 1 on both devices),
+ * which leaves the faces up, so the failure is also announced to every callback given
+ * to AddLinkCallback, once per end of the link: this is the (instant) failure detection
+ * recovery mechanisms such as LfaRoutingHelper and LinkStateRouter react to.
+ *
+ *     ndn::FailureHelper::ScheduleLinkFailure(nodes.Get(4), nodes.Get(7), Seconds(20), Seconds(30));
+ *     ndn::FailureHelper::TrackConsumers(consumerNodes);
+ *     ...
+ *     ndn::FailureHelper::PrintRecovery(std::cout);
+ *
+ * For every failure and tracked consumer, recovery is the time from the failure to the
+ * first Data answering an Interest sent after it; lost counts the Interests sent in
+ * between that were never answered.
+*/
+class FailureHelper {
+public:
+  /**
+   * \brief node, its face on the link, the node at the other end, whether the link is up
+  */
+  typedef std::function<void(Ptr<Node>, nfd::FaceId, Ptr<Node>, bool)> LinkCallback;
+
+  static void AddLinkCallback(const LinkCallback& callback) {
+    Callbacks().push_back(callback);
+  }
+
+  /**
+   * \brief Take the link between a and b down at down and, unless up is zero, back up at up
+  */
+  static void ScheduleLinkFailure(Ptr<Node> a, Ptr<Node> b, Time down, Time up = Time(0)) {
+    Simulator::Schedule(down, &FailureHelper::SetLink, a, b, false);
+    if (!up.IsZero()) {
+      Simulator::Schedule(up, &FailureHelper::SetLink, a, b, true);
+    }
+  }
+
+  /**
+   * \brief Take every link of the node down at down and, unless up is zero, back up at up
+  */
+  static void ScheduleNodeFailure(Ptr<Node> node, Time down, Time up = Time(0)) {
+    for (Ptr<Node> peer : Peers(node)) {
+      ScheduleLinkFailure(node, peer, down, up);
+    }
+  }
+
+  /**
+   * \brief Measure recovery at every application of the nodes
+  */
+  static void TrackConsumers(const NodeContainer& nodes) {
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); ++node) {
+      for (uint32_t i = 0; i < (*node)->GetNApplications(); i++) {
+        Ptr<App> app = DynamicCast<App>((*node)->GetApplication(i));
+        if (app != 0) {
+          Trackers().push_back(Create<RecoveryTracker>(app));
+        }
+      }
+    }
+  }
+
+  /**
+   *     Time Link Node App RecoveryMs Lost
+   *
+   * RecoveryMs is -1 when the consumer never recovered.
+  */
+  static void PrintRecovery(std::ostream& os) {
+    os << "Time" << "\t" << "Link" << "\t" << "Node" << "\t" << "App" << "\t" << "RecoveryMs" << "\t" << "Lost" << "\n";
+    for (const Ptr<RecoveryTracker>& tracker : Trackers()) {
+      tracker->Print(os);
+    }
+  }
+
+  static void Destroy() {
+    Trackers().clear();
+    Callbacks().clear();
+  }
+
+protected:
+  struct Failure {
+    Time time;
+    std::string link;
+  };
+
+  /**
+   * \brief Recovery windows of one consumer, one per failure
+  */
+  class RecoveryTracker : public SimpleRefCount<RecoveryTracker> {
+  public:
+    explicit RecoveryTracker(Ptr<App> app)
+      : m_app(app)
+      , m_purgeAt(1024) {
+      app->TraceConnectWithoutContext("TransmittedInterests", MakeCallback(&RecoveryTracker::Sent, this));
+      app->TraceConnectWithoutContext("ReceivedDatas", MakeCallback(&RecoveryTracker::Received, this));
+    }
+
+    void Fail(const Failure& failure) {
+      m_windows.push_back(Window{ failure, Time(-1), {} });
+    }
+
+    void Print(std::ostream& os) const {
+      for (const Window& window : m_windows) {
+        os << window.failure.time.GetSeconds() << "\t" << window.failure.link << "\t" << m_app->GetNode()->GetId()
+           << "\t" << m_app->GetId() << "\t"
+           << (window.recovered.IsNegative() ? -1 : (window.recovered - window.failure.time).GetMilliSeconds())
+           << "\t" << window.unanswered.size() << "\n";
+      }
+    }
+
+  private:
+    struct Window {
+      Failure failure;
+      Time recovered; // negative while open
+      std::unordered_set<Name> unanswered;
+    };
+
+    void Sent(shared_ptr<const Interest> interest, Ptr<App>, shared_ptr<Face>) {
+      m_sent[interest->getName()] = Simulator::Now();
+      for (Window& window : m_windows) {
+        if (window.recovered.IsNegative()) {
+          window.unanswered.insert(interest->getName());
+        }
+      }
+
+      if (m_sent.size() >= m_purgeAt) {
+        Time horizon = Simulator::Now() - Seconds(10);
+        for (auto i = m_sent.begin(); i != m_sent.end();) {
+          i = i->second < horizon ? m_sent.erase(i) : std::next(i);
+        }
+        m_purgeAt = std::max<std::size_t>(1024, 2 * m_sent.size());
+      }
+    }
+
+    void Received(shared_ptr<const Data> data, Ptr<App>, shared_ptr<Face>) {
+      auto sent = m_sent.find(data->getName());
+      if (sent == m_sent.end()) {
+        return;
+      }
+      for (Window& window : m_windows) {
+        window.unanswered.erase(data->getName());
+        if (window.recovered.IsNegative() && sent->second >= window.failure.time) {
+          window.recovered = Simulator::Now();
+        }
+      }
+      m_sent.erase(sent);
+    }
+
+  private:
+    Ptr<App> m_app;
+    std::unordered_map<Name, Time> m_sent; // pending interests -> last transmission
+    std::size_t m_purgeAt;
+    std::vector<Window> m_windows;
+  };
+
+  static std::list<LinkCallback>& Callbacks() {
+    static std::list<LinkCallback> callbacks;
+    return callbacks;
+  }
+
+  static std::list<Ptr<RecoveryTracker>>& Trackers() {
+    static std::list<Ptr<RecoveryTracker>> trackers;
+    return trackers;
+  }
+
+  static std::vector<Ptr<Node>> Peers(Ptr<Node> node) {
+    std::vector<Ptr<Node>> peers;
+    for (uint32_t i = 0; i < node->GetNDevices(); i++) {
+      Ptr<NetDevice> device = node->GetDevice(i);
+      Ptr<Channel> channel = device->GetChannel();
+      for (std::size_t j = 0; channel != 0 && j < channel->GetNDevices(); j++) {
+        if (channel->GetDevice(j) != device) {
+          peers.push_back(channel->GetDevice(j)->GetNode());
+        }
+      }
+    }
+    return peers;
+  }
+
+  /**
+   * \brief Face of node on its link to peer, 0 if none
+  */
+  static nfd::FaceId FaceTowards(Ptr<Node> node, Ptr<Node> peer) {
+    Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+    if (l3 == 0) {
+      return 0;
+    }
+    for (const Face& face : l3->getFaceTable()) {
+      NetDeviceTransport* transport = dynamic_cast<NetDeviceTransport*>(face.getTransport());
+      if (transport == nullptr || transport->GetNetDevice()->GetChannel() == 0) {
+        continue;
+      }
+      Ptr<Channel> channel = transport->GetNetDevice()->GetChannel();
+      for (std::size_t i = 0; i < channel->GetNDevices(); i++) {
+        if (channel->GetDevice(i)->GetNode() == peer) {
+          return face.getId();
+        }
+      }
+    }
+    return 0;
+  }
+
+  static void SetLink(Ptr<Node> a, Ptr<Node> b, bool up) {
+    if (up) {
+      LinkControlHelper::UpLink(a, b);
+    }
+    else {
+      LinkControlHelper::FailLink(a, b);
+      Failure failure{ Simulator::Now(), std::to_string(a->GetId()) + "-" + std::to_string(b->GetId()) };
+      for (const Ptr<RecoveryTracker>& tracker : Trackers()) {
+        tracker->Fail(failure);
+      }
+    }
+
+    for (const LinkCallback& callback : Callbacks()) {
+      callback(a, FaceTowards(a, b), b, up);
+      callback(b, FaceTowards(b, a), a, up);
+    }
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_FAILURE_HELPER_HPP
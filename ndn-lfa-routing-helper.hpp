@@ -0,0 +1,236 @@
+#ifndef NDNSIM_SCRATCH_NDN_LFA_ROUTING_HELPER_HPP
+#define NDNSIM_SCRATCH_NDN_LFA_ROUTING_HELPER_HPP
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/ptr.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-global-router.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "ndn-failure-helper.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Precomputed loop-free alternate (LFA, RFC 5286) next hops, switched in on failure
+ *
+ * CalculateBackups runs once, after GlobalRoutingHelper::CalculateRoutes (one best next
+ * hop per prefix). For every node S, prefix P and primary next hop, the backup is the
+ * neighbour N with the cheapest path to P among those for which
+ *
+ *     dist(N, P) < dist(N, S) + dist(S, P)
+ *
+ * i.e. N does not send the traffic back through S. Distances come from the GlobalRouter
+ * graph (face metrics as costs); dist to a prefix is the distance to its nearest origin.
+ *
+ * Backups are bucketed by primary face, so when FailureHelper reports a face down each
+ * of its routes is switched with one FIB add and one FIB remove, without any route
+ * computation; the primary is put back when the link comes up.
+*/
+class LfaRoutingHelper {
+public:
+  /**
+   * \brief Compute the backups of every node and start listening to FailureHelper
+  */
+  static void CalculateBackups() {
+    uint32_t n = NodeList::GetNNodes();
+    std::vector<std::vector<Link>> graph(n);
+    std::map<Name, std::vector<uint32_t>> origins;
+
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      Ptr<GlobalRouter> router = (*node)->GetObject<GlobalRouter>();
+      if (router == 0) {
+        continue;
+      }
+      uint32_t u = (*node)->GetId();
+      for (const GlobalRouter::Incidency& incidency : router->GetIncidencies()) {
+        uint32_t v = std::get<2>(incidency)->GetObject<Node>()->GetId();
+        const shared_ptr<Face>& face = std::get<1>(incidency);
+        graph[u].push_back(Link{ v, face->getId(), std::max<uint64_t>(1, static_cast<uint64_t>(face->getMetric())) });
+      }
+      for (const shared_ptr<Name>& prefix : router->GetLocalPrefixes()) {
+        origins[*prefix].push_back(u);
+      }
+    }
+
+    std::vector<std::vector<uint64_t>> dist(n);
+    for (uint32_t u = 0; u < n; u++) {
+      dist[u] = Dijkstra(graph, u);
+    }
+
+    for (uint32_t s = 0; s < n; s++) {
+      Ptr<L3Protocol> l3 = NodeList::GetNode(s)->GetObject<L3Protocol>();
+      if (l3 == 0 || graph[s].empty()) {
+        continue;
+      }
+      NodeBackups& backups = Registry()[s];
+      nfd::Fib& fib = l3->getForwarder()->getFib();
+
+      for (const std::pair<const Name, std::vector<uint32_t>>& prefix : origins) {
+        const std::vector<uint32_t>& to = prefix.second;
+        nfd::fib::Entry* entry = fib.findExactMatch(prefix.first);
+        if (entry == nullptr || std::find(to.begin(), to.end(), s) != to.end()) {
+          continue;
+        }
+        auto distance = [&](uint32_t x) {
+          uint64_t d = INF;
+          for (uint32_t origin : to) {
+            d = std::min(d, dist[x][origin]);
+          }
+          return d;
+        };
+        uint64_t here = distance(s);
+        backups.routes++;
+
+        for (const nfd::fib::NextHop& primary : entry->getNextHops()) {
+          const Link* best = nullptr;
+          uint64_t bestCost = INF;
+          for (const Link& link : graph[s]) {
+            uint64_t via = distance(link.to);
+            Face* face = l3->getFaceTable().get(link.face);
+            if (face == nullptr || entry->hasNextHop(*face) || via == INF || dist[link.to][s] == INF
+                || via >= dist[link.to][s] + here) {
+              continue;
+            }
+            if (link.cost + via < bestCost) {
+              best = &link;
+              bestCost = link.cost + via;
+            }
+          }
+          if (best != nullptr) {
+            backups.byPrimary[primary.getFace().getId()].push_back(
+              Backup{ prefix.first, primary.getFace().getId(), primary.getCost(), best->face, bestCost, false });
+            backups.protectedRoutes++;
+          }
+        }
+      }
+    }
+
+    if (!Registry().empty()) {
+      FailureHelper::AddLinkCallback(&LfaRoutingHelper::LinkChanged);
+    }
+  }
+
+  /**
+   *     Node Routes Protected Activations
+  */
+  static void PrintStats(std::ostream& os) {
+    os << "Node" << "\t" << "Routes" << "\t" << "Protected" << "\t" << "Activations" << "\n";
+    for (const std::pair<const uint32_t, NodeBackups>& node : Registry()) {
+      os << node.first << "\t" << node.second.routes << "\t" << node.second.protectedRoutes << "\t"
+         << node.second.activations << "\n";
+    }
+  }
+
+protected:
+  static constexpr uint64_t INF = std::numeric_limits<uint64_t>::max();
+
+  struct Link {
+    uint32_t to;
+    nfd::FaceId face;
+    uint64_t cost;
+  };
+
+  struct Backup {
+    Name prefix;
+    nfd::FaceId primary;
+    uint64_t primaryCost;
+    nfd::FaceId backup;
+    uint64_t backupCost;
+    bool added; // backup next hop put in the FIB by the activation
+  };
+
+  struct NodeBackups {
+    std::unordered_map<nfd::FaceId, std::vector<Backup>> byPrimary;
+    uint64_t routes = 0;
+    uint64_t protectedRoutes = 0;
+    uint64_t activations = 0;
+  };
+
+  static std::map<uint32_t, NodeBackups>& Registry() {
+    static std::map<uint32_t, NodeBackups> backups;
+    return backups;
+  }
+
+  static std::vector<uint64_t> Dijkstra(const std::vector<std::vector<Link>>& graph, uint32_t source) {
+    std::vector<uint64_t> dist(graph.size(), INF);
+    std::priority_queue<std::pair<uint64_t, uint32_t>, std::vector<std::pair<uint64_t, uint32_t>>,
+                        std::greater<std::pair<uint64_t, uint32_t>>> heap;
+    dist[source] = 0;
+    heap.emplace(0, source);
+    while (!heap.empty()) {
+      std::pair<uint64_t, uint32_t> top = heap.top();
+      heap.pop();
+      if (top.first != dist[top.second]) {
+        continue;
+      }
+      for (const Link& link : graph[top.second]) {
+        if (top.first + link.cost < dist[link.to]) {
+          dist[link.to] = top.first + link.cost;
+          heap.emplace(dist[link.to], link.to);
+        }
+      }
+    }
+    return dist;
+  }
+
+  static void LinkChanged(Ptr<Node> node, nfd::FaceId faceId, Ptr<Node>, bool up) {
+    auto backups = Registry().find(node->GetId());
+    if (backups == Registry().end()) {
+      return;
+    }
+    auto bucket = backups->second.byPrimary.find(faceId);
+    if (bucket == backups->second.byPrimary.end()) {
+      return;
+    }
+
+    Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+    nfd::Fib& fib = l3->getForwarder()->getFib();
+    Face* primary = l3->getFaceTable().get(faceId);
+    for (Backup& backup : bucket->second) {
+      Face* alternate = l3->getFaceTable().get(backup.backup);
+      if (primary == nullptr || alternate == nullptr) {
+        continue;
+      }
+
+      if (!up) {
+        nfd::fib::Entry* entry = fib.findExactMatch(backup.prefix);
+        if (entry == nullptr || !entry->hasNextHop(*primary)) {
+          continue;
+        }
+        // add first: removing the last next hop would erase the entry
+        backup.added = !entry->hasNextHop(*alternate);
+        if (backup.added) {
+          fib.addOrUpdateNextHop(*entry, *alternate, backup.backupCost);
+        }
+        fib.removeNextHop(*entry, *primary);
+        backups->second.activations++;
+      }
+      else {
+        nfd::fib::Entry* entry = fib.insert(backup.prefix).first;
+        fib.addOrUpdateNextHop(*entry, *primary, backup.primaryCost);
+        if (backup.added) {
+          fib.removeNextHop(*entry, *alternate);
+          backup.added = false;
+        }
+      }
+    }
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_LFA_ROUTING_HELPER_HPP
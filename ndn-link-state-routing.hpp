@@ -0,0 +1,575 @@
+#ifndef NDNSIM_SCRATCH_NDN_LINK_STATE_ROUTING_HPP
+#define NDNSIM_SCRATCH_NDN_LINK_STATE_ROUTING_HPP
+
+#include "ns3/application-container.h"
+#include "ns3/channel.h"
+#include "ns3/event-id.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/ndnSIM/apps/ndn-app.hpp"
+#include "ns3/ndnSIM/apps/ndn-producer.hpp"
+#include "ns3/ndnSIM/helper/ndn-strategy-choice-helper.hpp"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/model/ndn-net-device-transport.hpp"
+
+#include "incremental-spf.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Link state advertisement: the links and prefixes of one origin node
+ *
+ * Carried as the ApplicationParameters of an Interest
+ * /localhop/lsr/lsa/<origin>/<seq>/<sender>, host byte order:
+ *
+ *     origin u32, seq u64, nLinks u32, { neighbour u32, cost u64 } * nLinks,
+ *     nPrefixes u32, { size u32, Name TLV } * nPrefixes
+*/
+struct LinkStateAdvertisement {
+  uint32_t origin = 0;
+  uint64_t seq = 0;
+  std::vector<std::pair<uint32_t, uint64_t>> links;
+  std::vector<Name> prefixes;
+
+  std::vector<uint8_t> Encode() const {
+    std::vector<uint8_t> buffer;
+    Put(buffer, origin);
+    Put(buffer, seq);
+    Put(buffer, static_cast<uint32_t>(links.size()));
+    for (const std::pair<uint32_t, uint64_t>& link : links) {
+      Put(buffer, link.first);
+      Put(buffer, link.second);
+    }
+    Put(buffer, static_cast<uint32_t>(prefixes.size()));
+    for (const Name& prefix : prefixes) {
+      const Block& wire = prefix.wireEncode();
+      Put(buffer, static_cast<uint32_t>(wire.size()));
+      buffer.insert(buffer.end(), wire.wire(), wire.wire() + wire.size());
+    }
+    return buffer;
+  }
+
+  /**
+   * \returns false if the buffer is not a complete advertisement
+  */
+  bool Decode(const uint8_t* buffer, std::size_t size) {
+    std::size_t offset = 0;
+    uint32_t nLinks = 0;
+    uint32_t nPrefixes = 0;
+    if (!Get(buffer, size, offset, origin) || !Get(buffer, size, offset, seq) || !Get(buffer, size, offset, nLinks)) {
+      return false;
+    }
+
+    links.clear();
+    for (uint32_t i = 0; i < nLinks; i++) {
+      std::pair<uint32_t, uint64_t> link;
+      if (!Get(buffer, size, offset, link.first) || !Get(buffer, size, offset, link.second)) {
+        return false;
+      }
+      links.push_back(link);
+    }
+
+    prefixes.clear();
+    if (!Get(buffer, size, offset, nPrefixes)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < nPrefixes; i++) {
+      uint32_t length = 0;
+      if (!Get(buffer, size, offset, length) || size - offset < length) {
+        return false;
+      }
+      prefixes.push_back(Name(Block(buffer + offset, length)));
+      offset += length;
+    }
+    return true;
+  }
+
+private:
+  template<class T>
+  static void Put(std::vector<uint8_t>& buffer, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+  }
+
+  template<class T>
+  static bool Get(const uint8_t* buffer, std::size_t size, std::size_t& offset, T& value) {
+    if (size - offset < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, buffer + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+  }
+};
+
+/**
+ * \brief Link state routing protocol of one node, run as an application
+ *
+ * Every router announces its up links (face metric as cost) and the prefixes announced
+ * on its node in one LSA, flooded hop by hop: the Interest goes out on all faces through
+ * /localhop/lsr (multicast strategy, /localhop keeps it one hop) and each router
+ * re-sends an LSA newer than what it has. Nothing answers these Interests.
+ *
+ * A received LSA feeds an IncrementalSpf rooted at the node; only destinations whose
+ * distance or first hop changed, and prefixes whose origins changed, touch the FIB.
+ * Routes are written directly in the forwarder's FIB (cost = path cost), next to the
+ * ones of the RIB, which never manages these prefixes.
+ *
+ * There is no acknowledgement or periodic refresh: the state is consistent as long as
+ * LSAs are not lost; a lost LSA is repaired by the origin's next change.
+*/
+class LinkStateRouter : public App {
+public:
+  static TypeId GetTypeId() {
+    static TypeId tid = TypeId("ns3::ndn::LinkStateRouter")
+      .SetGroupName("Ndn")
+      .SetParent<App>()
+      .AddConstructor<LinkStateRouter>()
+      .AddAttribute("LsaLifetime", "Lifetime of the Interests carrying LSAs",
+        StringValue("1s"),
+        MakeTimeAccessor(&LinkStateRouter::m_lsaLifetime),
+        MakeTimeChecker())
+      .AddAttribute("Jitter", "Upper bound of the random delay before the first LSA",
+        StringValue("50ms"),
+        MakeTimeAccessor(&LinkStateRouter::m_jitter),
+        MakeTimeChecker());
+    return tid;
+  }
+
+  /**
+   * \brief Control plane counters of one router
+  */
+  struct Counters {
+    uint64_t originated = 0;
+    uint64_t sent = 0;     // LSA Interests, own and re-flooded
+    uint64_t received = 0;
+    uint64_t bytesSent = 0;
+    uint64_t spfRuns = 0;
+    uint64_t settled = 0;  // nodes settled by the incremental SPF
+    double cpuSeconds = 0; // wall clock spent applying LSAs (SPF and FIB)
+    uint64_t fibUpdates = 0;
+  };
+
+  /**
+   * \brief When an LSA was originated and when the last router applied it
+  */
+  static std::map<std::pair<uint32_t, uint64_t>, std::pair<Time, Time>>& Convergence() {
+    static std::map<std::pair<uint32_t, uint64_t>, std::pair<Time, Time>> convergence;
+    return convergence;
+  }
+
+  static Ptr<LinkStateRouter> Find(Ptr<Node> node) {
+    for (uint32_t i = 0; i < node->GetNApplications(); i++) {
+      Ptr<LinkStateRouter> router = DynamicCast<LinkStateRouter>(node->GetApplication(i));
+      if (router != 0) {
+        return router;
+      }
+    }
+    return 0;
+  }
+
+  LinkStateRouter()
+    : m_rand(CreateObject<UniformRandomVariable>())
+    , m_seq(0)
+    , m_started(false) {
+  }
+
+  void Announce(const Name& prefix) {
+    if (m_prefixes.insert(prefix).second && m_started) {
+      Originate();
+    }
+  }
+
+  void Withdraw(const Name& prefix) {
+    if (m_prefixes.erase(prefix) > 0 && m_started) {
+      Originate();
+    }
+  }
+
+  /**
+   * \brief Mark the link to a neighbour up or down (also done on face state changes)
+  */
+  void SetLinkUp(uint32_t neighbour, bool up) {
+    auto link = m_neighbours.find(neighbour);
+    if (link == m_neighbours.end() || link->second.up == up) {
+      return;
+    }
+    link->second.up = up;
+    if (m_started) {
+      Originate();
+    }
+  }
+
+  const Counters& GetCounters() const {
+    return m_counters;
+  }
+
+  void OnInterest(shared_ptr<const Interest> interest) override {
+    if (!m_active) {
+      return;
+    }
+    App::OnInterest(interest);
+
+    if (!interest->hasApplicationParameters()) {
+      return;
+    }
+    const Block& parameters = interest->getApplicationParameters();
+    LinkStateAdvertisement lsa;
+    if (!lsa.Decode(parameters.value(), parameters.value_size())) {
+      return;
+    }
+    m_counters.received++;
+
+    uint32_t self = GetNode()->GetId();
+    auto known = m_lsdb.find(lsa.origin);
+    if (lsa.origin == self || (known != m_lsdb.end() && known->second.seq >= lsa.seq)) {
+      return; // own or already flooded
+    }
+
+    Send(lsa);
+    if (known == m_lsdb.end()) {
+      known = m_lsdb.emplace(lsa.origin, LinkStateAdvertisement()).first;
+      known->second.origin = lsa.origin;
+    }
+    Apply(known->second, lsa);
+  }
+
+protected:
+  static const Name& FloodPrefix() {
+    static const Name prefix("/localhop/lsr/lsa");
+    return prefix;
+  }
+
+  struct Neighbour {
+    nfd::FaceId face;
+    bool up;
+  };
+
+  void StartApplication() override {
+    App::StartApplication();
+    uint32_t self = GetNode()->GetId();
+    m_spf.reset(new IncrementalSpf(self));
+
+    Ptr<L3Protocol> l3 = GetNode()->GetObject<L3Protocol>();
+    nfd::Fib& fib = l3->getForwarder()->getFib();
+    nfd::fib::Entry* flood = fib.insert(FloodPrefix()).first;
+    fib.addOrUpdateNextHop(*flood, *m_face, 0);
+
+    for (Face& face : l3->getFaceTable()) {
+      NetDeviceTransport* transport = dynamic_cast<NetDeviceTransport*>(face.getTransport());
+      if (transport == nullptr || transport->GetNetDevice()->GetChannel() == 0) {
+        continue;
+      }
+      Ptr<NetDevice> device = transport->GetNetDevice();
+      Ptr<Channel> channel = device->GetChannel();
+      for (std::size_t i = 0; i < channel->GetNDevices(); i++) {
+        Ptr<Node> peer = channel->GetDevice(i)->GetNode();
+        if (channel->GetDevice(i) == device || peer->GetObject<L3Protocol>() == 0) {
+          continue;
+        }
+        m_neighbours[peer->GetId()] = Neighbour{ face.getId(), face.getState() == nfd::face::FaceState::UP };
+        fib.addOrUpdateNextHop(*flood, face, 1);
+
+        uint32_t neighbour = peer->GetId();
+        m_stateConns.emplace_back(face.afterStateChange.connect(
+          [this, neighbour](nfd::face::FaceState, nfd::face::FaceState state) {
+            SetLinkUp(neighbour, state == nfd::face::FaceState::UP);
+          }));
+      }
+    }
+
+    m_started = true;
+    m_originateEvent = Simulator::Schedule(Seconds(m_rand->GetValue(0, m_jitter.GetSeconds())),
+                                           &LinkStateRouter::Originate, this);
+  }
+
+  void StopApplication() override {
+    m_started = false;
+    Simulator::Cancel(m_originateEvent);
+    m_stateConns.clear();
+    App::StopApplication();
+  }
+
+  void Originate() {
+    Ptr<L3Protocol> l3 = GetNode()->GetObject<L3Protocol>();
+    LinkStateAdvertisement lsa;
+    lsa.origin = GetNode()->GetId();
+    lsa.seq = ++m_seq;
+    for (const std::pair<const uint32_t, Neighbour>& neighbour : m_neighbours) {
+      Face* face = l3->getFaceTable().get(neighbour.second.face);
+      if (neighbour.second.up && face != nullptr) {
+        lsa.links.emplace_back(neighbour.first, std::max<uint64_t>(1, static_cast<uint64_t>(face->getMetric())));
+      }
+    }
+    lsa.prefixes.assign(m_prefixes.begin(), m_prefixes.end());
+
+    m_counters.originated++;
+    Convergence()[std::make_pair(lsa.origin, lsa.seq)] = std::make_pair(Simulator::Now(), Simulator::Now());
+    Send(lsa);
+    Apply(m_self, lsa);
+  }
+
+  void Send(const LinkStateAdvertisement& lsa) {
+    Name name(FloodPrefix());
+    name.appendNumber(lsa.origin).appendNumber(lsa.seq).appendNumber(GetNode()->GetId());
+
+    std::vector<uint8_t> buffer = lsa.Encode();
+    shared_ptr<Interest> interest = make_shared<Interest>(name);
+    interest->setApplicationParameters(buffer.data(), buffer.size());
+    interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+    interest->setInterestLifetime(time::milliseconds(m_lsaLifetime.GetMilliSeconds()));
+
+    m_counters.sent++;
+    m_counters.bytesSent += interest->wireEncode().size();
+    m_transmittedInterests(interest, this, m_face);
+    m_appLink->onReceiveInterest(*interest);
+  }
+
+  /**
+   * \brief Replace the stored LSA of an origin and repair routes incrementally
+  */
+  void Apply(LinkStateAdvertisement& stored, const LinkStateAdvertisement& lsa) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+
+    std::set<Name> dirty;
+    std::set<Name> before(stored.prefixes.begin(), stored.prefixes.end());
+    std::set<Name> after(lsa.prefixes.begin(), lsa.prefixes.end());
+    for (const Name& prefix : before) {
+      if (after.count(prefix) == 0) {
+        m_origins[prefix].erase(lsa.origin);
+        dirty.insert(prefix);
+      }
+    }
+    for (const Name& prefix : after) {
+      if (before.count(prefix) == 0) {
+        m_origins[prefix].insert(lsa.origin);
+        dirty.insert(prefix);
+      }
+    }
+
+    if (stored.links != lsa.links) {
+      uint64_t settled = m_spf->GetSettled();
+      m_spf->SetLinks(lsa.origin, lsa.links);
+      for (uint32_t node : m_spf->Update()) {
+        auto origin = m_lsdb.find(node);
+        if (origin != m_lsdb.end()) {
+          dirty.insert(origin->second.prefixes.begin(), origin->second.prefixes.end());
+        }
+      }
+      m_counters.spfRuns++;
+      m_counters.settled += m_spf->GetSettled() - settled;
+    }
+
+    stored.seq = lsa.seq;
+    stored.links = lsa.links;
+    stored.prefixes = lsa.prefixes;
+
+    for (const Name& prefix : dirty) {
+      UpdateRoute(prefix);
+    }
+
+    m_counters.cpuSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+    auto convergence = Convergence().find(std::make_pair(lsa.origin, lsa.seq));
+    if (convergence != Convergence().end()) {
+      convergence->second.second = std::max(convergence->second.second, Simulator::Now());
+    }
+  }
+
+  /**
+   * \brief Point the FIB entry of a prefix at the first hops towards its nearest origins
+  */
+  void UpdateRoute(const Name& prefix) {
+    uint32_t self = GetNode()->GetId();
+    Ptr<L3Protocol> l3 = GetNode()->GetObject<L3Protocol>();
+    std::map<nfd::FaceId, uint64_t> wanted;
+
+    auto origins = m_origins.find(prefix);
+    if (origins != m_origins.end()) {
+      for (uint32_t origin : origins->second) {
+        uint32_t hop = m_spf->FirstHop(origin);
+        auto neighbour = m_neighbours.find(hop);
+        if (origin == self || neighbour == m_neighbours.end()) {
+          continue;
+        }
+        uint64_t& cost = wanted.emplace(neighbour->second.face, IncrementalSpf::INF).first->second;
+        cost = std::min(cost, m_spf->Distance(origin));
+      }
+      if (origins->second.empty()) {
+        m_origins.erase(origins);
+      }
+    }
+
+    std::map<nfd::FaceId, uint64_t>& installed = m_installed[prefix];
+    if (installed == wanted) {
+      return;
+    }
+
+    nfd::Fib& fib = l3->getForwarder()->getFib();
+    if (!wanted.empty()) {
+      nfd::fib::Entry* entry = fib.insert(prefix).first;
+      for (const std::pair<const nfd::FaceId, uint64_t>& hop : wanted) {
+        Face* face = l3->getFaceTable().get(hop.first);
+        if (face != nullptr) {
+          fib.addOrUpdateNextHop(*entry, *face, hop.second);
+        }
+      }
+    }
+    for (const std::pair<const nfd::FaceId, uint64_t>& hop : installed) {
+      nfd::fib::Entry* entry = fib.findExactMatch(prefix);
+      Face* face = l3->getFaceTable().get(hop.first);
+      if (wanted.count(hop.first) == 0 && entry != nullptr && face != nullptr) {
+        fib.removeNextHop(*entry, *face);
+      }
+    }
+    nfd::fib::Entry* entry = fib.findExactMatch(prefix);
+    if (entry != nullptr && !entry->hasNextHops()) {
+      fib.erase(*entry);
+    }
+
+    m_counters.fibUpdates++;
+    if (wanted.empty()) {
+      m_installed.erase(prefix);
+    }
+    else {
+      installed = wanted;
+    }
+  }
+
+protected:
+  Ptr<UniformRandomVariable> m_rand;
+  Time m_lsaLifetime;
+  Time m_jitter;
+
+  uint64_t m_seq;
+  bool m_started;
+  EventId m_originateEvent;
+  std::set<Name> m_prefixes; // announced on this node
+  std::map<uint32_t, Neighbour> m_neighbours;
+  std::list<::ndn::util::signal::ScopedConnection> m_stateConns;
+
+  std::unique_ptr<IncrementalSpf> m_spf;
+  LinkStateAdvertisement m_self;
+  std::unordered_map<uint32_t, LinkStateAdvertisement> m_lsdb; // other origins
+  std::map<Name, std::set<uint32_t>> m_origins;                // prefix -> origins announcing it
+  std::map<Name, std::map<nfd::FaceId, uint64_t>> m_installed; // prefix -> next hops in the FIB
+
+  Counters m_counters;
+};
+
+NS_OBJECT_ENSURE_REGISTERED(LinkStateRouter);
+
+/**
+ * \brief Runs a LinkStateRouter on nodes, in place of GlobalRoutingHelper::CalculateRoutes
+ *
+ *     ndn::LinkStateRoutingHelper lsr;
+ *     lsr.InstallAll();
+ *     lsr.AnnounceProducers(producerNodes); // after the producers' start/stop are set
+ *     ...
+ *     ndn::LinkStateRoutingHelper::PrintStats(std::cout);
+*/
+class LinkStateRoutingHelper {
+public:
+  void Install(const NodeContainer& nodes) const {
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); ++node) {
+      if ((*node)->GetObject<L3Protocol>() == 0 || LinkStateRouter::Find(*node) != 0) {
+        continue;
+      }
+      StrategyChoiceHelper::Install(*node, "/localhop/lsr", "/localhost/nfd/strategy/multicast");
+      Ptr<LinkStateRouter> router = CreateObject<LinkStateRouter>();
+      (*node)->AddApplication(router);
+      router->SetStartTime(Seconds(0));
+    }
+  }
+
+  void InstallAll() const {
+    Install(NodeContainer::GetGlobal());
+  }
+
+  /**
+   * \brief Announce the prefix of every Producer on the nodes while it runs
+   * (from its StartTime to its StopTime)
+  */
+  void AnnounceProducers(const NodeContainer& nodes) const {
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); ++node) {
+      Ptr<LinkStateRouter> router = LinkStateRouter::Find(*node);
+      if (router == 0) {
+        continue;
+      }
+      for (uint32_t i = 0; i < (*node)->GetNApplications(); i++) {
+        Ptr<Producer> producer = DynamicCast<Producer>((*node)->GetApplication(i));
+        if (producer == 0) {
+          continue;
+        }
+        NameValue prefix;
+        TimeValue start, stop;
+        producer->GetAttribute("Prefix", prefix);
+        producer->GetAttribute("StartTime", start);
+        producer->GetAttribute("StopTime", stop);
+        Simulator::Schedule(start.Get(), &LinkStateRouter::Announce, router, prefix.Get());
+        if (!stop.Get().IsZero()) {
+          Simulator::Schedule(stop.Get(), &LinkStateRouter::Withdraw, router, prefix.Get());
+        }
+      }
+    }
+  }
+
+  /**
+   * \brief Per router counters, then the convergence of every LSA (origination to the
+   * last router applying it)
+   *
+   *     Node Originated Sent Received BytesSent SpfRuns Settled CpuUs FibUpdates
+  */
+  static void PrintStats(std::ostream& os) {
+    os << "Node" << "\t" << "Originated" << "\t" << "Sent" << "\t" << "Received" << "\t" << "BytesSent" << "\t"
+       << "SpfRuns" << "\t" << "Settled" << "\t" << "CpuUs" << "\t" << "FibUpdates" << "\n";
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+      Ptr<LinkStateRouter> router = LinkStateRouter::Find(*node);
+      if (router == 0) {
+        continue;
+      }
+      const LinkStateRouter::Counters& c = router->GetCounters();
+      os << (*node)->GetId() << "\t" << c.originated << "\t" << c.sent << "\t" << c.received << "\t" << c.bytesSent
+         << "\t" << c.spfRuns << "\t" << c.settled << "\t" << static_cast<uint64_t>(c.cpuSeconds * 1e6) << "\t"
+         << c.fibUpdates << "\n";
+    }
+
+    double total = 0, max = 0;
+    for (const auto& lsa : LinkStateRouter::Convergence()) {
+      double seconds = (lsa.second.second - lsa.second.first).GetSeconds();
+      total += seconds;
+      max = std::max(max, seconds);
+    }
+    std::size_t count = LinkStateRouter::Convergence().size();
+    os << "LSAs " << count << ", convergence mean " << (count == 0 ? 0 : total / count * 1000) << " ms, max "
+       << max * 1000 << " ms\n";
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_LINK_STATE_ROUTING_HPP
@@ -0,0 +1,136 @@
+#ifndef NDNSIM_SCRATCH_NDN_NODE_STATS_FORMAT_HPP
+#define NDNSIM_SCRATCH_NDN_NODE_STATS_FORMAT_HPP
+
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+
+#include "ndn-node-stats.hpp"
+
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+
+/**
+ * \brief Optional formatters for stats::NodeStats snapshots
+ *
+ * Collecting never formats; these are only needed when the snapshot is written out.
+*/
+
+namespace ns3 {
+namespace ndn {
+namespace stats {
+
+/**
+ * \brief Human readable block per node (cs, pit, fib and a face table)
+*/
+inline void WriteText(std::ostream& os, const NodeStats* stats, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) {
+    const NodeStats& s = stats[i];
+    if (!s.hasNdn) {
+      os << "NodeInfo [ " << s.nodeId << " ] Ndn is not installed\n\n";
+      continue;
+    }
+
+    os << "NodeInfo [ " << s.nodeId << " ]\n";
+    os << "Cs-Policy : " << s.csPolicy << "\n";
+    os << "Cs-Stored Packets : " << s.csSize << "\n";
+    os << "Cs-Size : " << s.csLimit << "\n";
+    os << "Cs-Hits/Misses : " << s.csHits << "/" << s.csMisses << "\n";
+    os << "Pit-Size : " << s.pitSize << "\n";
+    os << "Fib-Size : " << s.fibSize << "\n";
+    os << "Face-Table-Count : " << s.nFaces << "\n";
+
+    os << "Face-Table Items\n";
+    for (uint32_t f = 0; f < s.nFaceStats; f++) {
+      const FaceStats& face = s.faces[f];
+      os << std::setw(4) << std::right << f + 1 << ") ";
+      os << std::setw(3) << std::right << face.faceId << " ";
+      // as names, through the operator<< of FaceState and FaceScope
+      os << std::setw(6) << std::right << static_cast<::nfd::face::FaceState>(face.state) << " ";
+      os << std::setw(10) << std::right << static_cast<::ndn::nfd::FaceScope>(face.scope) << " ";
+      os << std::setw(8) << std::right << face.nInInterests << " ";
+      os << std::setw(8) << std::right << face.nOutInterests << " ";
+      os << std::setw(8) << std::right << face.nInData << " ";
+      os << std::setw(8) << std::right << face.nOutData << "\n";
+    }
+    os << "\n";
+  }
+}
+
+inline void WriteCsvHeader(std::ostream& os) {
+  os << "Time,Node,CsPolicy,CsSize,CsLimit,CsHits,CsMisses,PitSize,FibSize,"
+     << "FaceId,InInterests,OutInterests,InData,OutData,InNacks,OutNacks,InBytes,OutBytes\n";
+}
+
+/**
+ * \brief One row per face (one row with an empty face for nodes without faces)
+*/
+inline void WriteCsv(std::ostream& os, double time, const NodeStats* stats, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) {
+    const NodeStats& s = stats[i];
+    if (!s.hasNdn) {
+      continue;
+    }
+
+    for (uint32_t f = 0; f < s.nFaceStats || f == 0; f++) {
+      os << time << "," << s.nodeId << "," << s.csPolicy << "," << s.csSize << "," << s.csLimit << ","
+         << s.csHits << "," << s.csMisses << "," << s.pitSize << "," << s.fibSize << ",";
+      if (f < s.nFaceStats) {
+        const FaceStats& face = s.faces[f];
+        os << face.faceId << "," << face.nInInterests << "," << face.nOutInterests << ","
+           << face.nInData << "," << face.nOutData << "," << face.nInNacks << "," << face.nOutNacks << ","
+           << face.nInBytes << "," << face.nOutBytes;
+      }
+      else {
+        os << ",,,,,,,,";
+      }
+      os << "\n";
+    }
+  }
+}
+
+/**
+ * \brief Pool totals and one line per size class that was used
+*/
+inline void WriteText(std::ostream& os, const PoolStats& s) {
+  os << "PacketPool : " << (s.enabled ? "enabled" : "disabled") << "\n";
+  os << "Allocations/Frees : " << s.allocations << "/" << s.frees << "\n";
+  os << "Pooled : " << s.pooled << "\n";
+  os << "Mallocs : " << s.mallocs << "\n";
+  os << "Arena-Bytes : " << s.arenaBytes << "\n";
+
+  os << "Size-Classes\n";
+  for (const PacketPool::ClassStats& c : s.classes) {
+    if (c.allocations == 0) {
+      continue;
+    }
+    os << std::setw(6) << std::right << c.size << " ";
+    os << std::setw(12) << std::right << c.allocations << " ";
+    os << std::setw(10) << std::right << c.carved << " ";
+    os << std::setw(10) << std::right << c.freeBlocks << "\n";
+  }
+  os << "\n";
+}
+
+/**
+ * \brief Raw records in host byte order: time, node count, then per node the fixed
+ * NodeStats fields without the policy name, nFaceStats and that many FaceStats
+*/
+inline void WriteBinary(std::ostream& os, double time, const NodeStats* stats, std::size_t n) {
+  uint64_t count = n;
+  os.write(reinterpret_cast<const char*>(&time), sizeof(time));
+  os.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+  for (std::size_t i = 0; i < n; i++) {
+    const NodeStats& s = stats[i];
+    const uint64_t fields[] = { s.nodeId, s.hasNdn, s.csSize, s.csLimit, s.csHits, s.csMisses,
+                                s.pitSize, s.fibSize, s.nameTreeSize, s.nFaces, s.nFaceStats };
+    os.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+    os.write(reinterpret_cast<const char*>(s.faces), sizeof(FaceStats) * s.nFaceStats);
+  }
+}
+
+} // namespace stats
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_NODE_STATS_FORMAT_HPP
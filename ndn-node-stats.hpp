@@ -0,0 +1,137 @@
+#ifndef NDNSIM_SCRATCH_NDN_NODE_STATS_HPP
+#define NDNSIM_SCRATCH_NDN_NODE_STATS_HPP
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/ptr.h"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "packet-pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ns3 {
+namespace ndn {
+namespace stats {
+
+/**
+ * \brief Faces reported per node; faces beyond this are counted in NodeStats::nFaces only
+*/
+constexpr std::size_t MAX_FACES = 64;
+
+struct FaceStats {
+  uint64_t faceId;
+  uint8_t scope; // ndn::nfd::FaceScope
+  uint8_t state; // nfd::face::FaceState
+  uint64_t nInInterests;
+  uint64_t nOutInterests;
+  uint64_t nInData;
+  uint64_t nOutData;
+  uint64_t nInNacks;
+  uint64_t nOutNacks;
+  uint64_t nInBytes;
+  uint64_t nOutBytes;
+};
+
+/**
+ * \brief Snapshot of one node, filled in place by Collect
+ *
+ * csPolicy points to the name held by the node's CS policy and stays valid as long as
+ * the policy is not replaced.
+*/
+struct NodeStats {
+  uint32_t nodeId;
+  bool hasNdn;
+  const char* csPolicy;
+  uint64_t csSize;
+  uint64_t csLimit;
+  uint64_t csHits;
+  uint64_t csMisses;
+  uint64_t pitSize;
+  uint64_t fibSize;
+  uint64_t nameTreeSize;
+  uint32_t nFaces;     // faces in the face table
+  uint32_t nFaceStats; // entries of faces[] filled, at most MAX_FACES
+  FaceStats faces[MAX_FACES];
+};
+
+/**
+ * \brief Fill out with the current state of node; makes no allocation
+*/
+inline void Collect(Ptr<Node> node, NodeStats& out) {
+  out.nodeId = node->GetId();
+  out.nFaces = 0;
+  out.nFaceStats = 0;
+
+  Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+  out.hasNdn = l3 != 0;
+  if (!out.hasNdn) {
+    out.csPolicy = "None";
+    out.csSize = out.csLimit = out.csHits = out.csMisses = 0;
+    out.pitSize = out.fibSize = out.nameTreeSize = 0;
+    return;
+  }
+
+  nfd::Forwarder& forwarder = *l3->getForwarder();
+  nfd::Cs& cs = forwarder.getCs();
+  out.csPolicy = cs.getPolicy()->getName().c_str();
+  out.csSize = cs.size();
+  out.csLimit = cs.getLimit();
+  out.csHits = forwarder.getCounters().nCsHits;
+  out.csMisses = forwarder.getCounters().nCsMisses;
+  out.pitSize = forwarder.getPit().size();
+  out.fibSize = forwarder.getFib().size();
+  out.nameTreeSize = forwarder.getNameTree().size();
+
+  for (const Face& face : l3->getFaceTable()) {
+    out.nFaces++;
+    if (out.nFaceStats == MAX_FACES) {
+      continue;
+    }
+
+    const nfd::face::FaceCounters& counters = face.getCounters();
+    FaceStats& fs = out.faces[out.nFaceStats++];
+    fs.faceId = face.getId();
+    fs.scope = static_cast<uint8_t>(face.getScope());
+    fs.state = static_cast<uint8_t>(face.getState());
+    fs.nInInterests = counters.nInInterests;
+    fs.nOutInterests = counters.nOutInterests;
+    fs.nInData = counters.nInData;
+    fs.nOutData = counters.nOutData;
+    fs.nInNacks = counters.nInNacks;
+    fs.nOutNacks = counters.nOutNacks;
+    fs.nInBytes = counters.nInBytes;
+    fs.nOutBytes = counters.nOutBytes;
+  }
+}
+
+/**
+ * \brief Fill out[] with the first capacity nodes of NodeList
+ * \returns number of entries filled
+*/
+inline std::size_t CollectAll(NodeStats* out, std::size_t capacity) {
+  std::size_t n = 0;
+  for (NodeList::Iterator i = NodeList::Begin(); i != NodeList::End() && n < capacity; ++i) {
+    Collect(*i, out[n++]);
+  }
+  return n;
+}
+
+/**
+ * \brief Allocator counters of the simulation thread (see PacketPool)
+*/
+typedef PacketPool::Stats PoolStats;
+
+/**
+ * \brief Fill out with the PacketPool counters; makes no allocation
+*/
+inline void CollectPool(PoolStats& out) {
+  PacketPool::Collect(out);
+}
+
+} // namespace stats
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_NODE_STATS_HPP
@@ -0,0 +1,265 @@
+#ifndef NDNSIM_SCRATCH_NDN_RTT_FIB_COST_HPP
+#define NDNSIM_SCRATCH_NDN_RTT_FIB_COST_HPP
+
+#include "ns3/event-id.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * \brief Keeps the FIB next hop costs of a node equal to the measured RTT of each face
+ *
+ * Every Interest sent on a non-local face is timestamped per (name, face); the Data
+ * coming back on that face gives an RTT sample for (FIB prefix, face), smoothed like
+ * TCP's SRTT, so an Interest sent on several faces gives a sample for each face that
+ * answers. Interests sent twice on the same face give no sample (Karn).
+ *
+ * Every period the smoothed RTTs (in milliseconds, the unit of
+ * StackHelper::SetLinkDelayAsFaceMetric) are written in place with
+ * Fib::addOrUpdateNextHop, which reorders the next hops. Only existing next hops are
+ * updated, and to bound the cost:
+ *
+ * - a cost is rewritten only if it moved by more than the hysteresis (relative) and by
+ *   at least 1 ms
+ * - at most maxUpdates costs are rewritten per period, largest changes first
+*/
+class RttFibCost : public SimpleRefCount<RttFibCost> {
+public:
+  struct Config {
+    Time period = Seconds(1);
+    double alpha = 0.125;     // weight of a new sample
+    double hysteresis = 0.2;  // relative change needed to rewrite a cost
+    std::size_t maxUpdates = 16;
+  };
+
+  static void InstallAll(const Config& config = Config()) {
+    NodeContainer nodes;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      nodes.Add(*node);
+    }
+    Install(nodes, config);
+  }
+
+  static void Install(const NodeContainer& nodes, const Config& config = Config()) {
+    for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+      if ((*node)->GetObject<L3Protocol>() == 0) {
+        continue;
+      }
+      Registry().push_back(Create<RttFibCost>(*node, config));
+    }
+  }
+
+  static void Destroy() {
+    Registry().clear();
+  }
+
+  /**
+   * \brief Samples taken and costs rewritten by every installed node
+   *
+   *     Node Samples Updates
+  */
+  static void PrintStats(std::ostream& os) {
+    os << "Node" << "\t" << "Samples" << "\t" << "Updates" << "\n";
+    for (const Ptr<RttFibCost>& cost : Registry()) {
+      os << cost->m_node->GetId() << "\t" << cost->m_samples << "\t" << cost->m_updates << "\n";
+    }
+  }
+
+  RttFibCost(Ptr<Node> node, const Config& config)
+    : m_node(node)
+    , m_config(config)
+    , m_purgeAt(1024)
+    , m_samples(0)
+    , m_updates(0) {
+    Ptr<L3Protocol> l3 = m_node->GetObject<L3Protocol>();
+    m_forwarder = l3->getForwarder();
+
+    l3->TraceConnectWithoutContext("OutInterests", MakeCallback(&RttFibCost::OutInterest, this));
+    l3->TraceConnectWithoutContext("InData", MakeCallback(&RttFibCost::InData, this));
+
+    m_event = Simulator::Schedule(m_config.period, &RttFibCost::Update, this);
+  }
+
+  ~RttFibCost() {
+    m_event.Cancel();
+  }
+
+protected:
+  struct Pending {
+    nfd::FaceId face;
+    Time sent;
+    bool retransmitted;
+  };
+
+  struct Estimate {
+    double srtt = 0; // ms
+    uint64_t installed = 0;
+    bool fresh = false; // new samples since the last update
+  };
+
+  struct Prefix {
+    Name name;
+    std::unordered_map<nfd::FaceId, Estimate> faces;
+  };
+
+  struct Change {
+    double delta;
+    Prefix* prefix;
+    nfd::FaceId face;
+    uint64_t cost;
+  };
+
+  static std::size_t PendingKey(const Name& name, nfd::FaceId face) {
+    return std::hash<Name>()(name) ^ static_cast<std::size_t>(face * 0x9e3779b97f4a7c15ULL);
+  }
+
+  static std::list<Ptr<RttFibCost>>& Registry() {
+    static std::list<Ptr<RttFibCost>> costs;
+    return costs;
+  }
+
+  void OutInterest(const Interest& interest, const Face& face) {
+    if (face.getScope() == ::ndn::nfd::FACE_SCOPE_LOCAL) {
+      return;
+    }
+
+    std::size_t key = PendingKey(interest.getName(), face.getId());
+    auto pending = m_pending.find(key);
+    if (pending != m_pending.end()) {
+      pending->second.retransmitted = pending->second.retransmitted || pending->second.face == face.getId();
+      pending->second.face = face.getId();
+      pending->second.sent = Simulator::Now();
+      return;
+    }
+    m_pending.emplace(key, Pending{ face.getId(), Simulator::Now(), false });
+
+    // interests never answered are never looked up again
+    if (m_pending.size() >= m_purgeAt) {
+      Time horizon = Simulator::Now() - Seconds(10);
+      for (auto i = m_pending.begin(); i != m_pending.end();) {
+        i = i->second.sent < horizon ? m_pending.erase(i) : std::next(i);
+      }
+      m_purgeAt = std::max<std::size_t>(1024, 2 * m_pending.size());
+    }
+  }
+
+  void InData(const Data& data, const Face& face) {
+    auto pending = m_pending.find(PendingKey(data.getName(), face.getId()));
+    if (pending == m_pending.end()) {
+      return;
+    }
+    Pending sent = pending->second;
+    m_pending.erase(pending);
+    if (sent.face != face.getId() || sent.retransmitted) {
+      return;
+    }
+
+    const nfd::fib::Entry& entry = m_forwarder->getFib().findLongestPrefixMatch(data.getName());
+    if (!entry.hasNextHop(face)) {
+      return;
+    }
+
+    Prefix& prefix = m_prefixes[std::hash<Name>()(entry.getPrefix())];
+    if (prefix.name.empty()) {
+      prefix.name = entry.getPrefix();
+    }
+
+    double sample = (Simulator::Now() - sent.sent).GetSeconds() * 1000;
+    auto estimate = prefix.faces.find(face.getId());
+    if (estimate == prefix.faces.end()) {
+      estimate = prefix.faces.emplace(face.getId(), Estimate()).first;
+      estimate->second.srtt = sample;
+    }
+    else {
+      estimate->second.srtt += m_config.alpha * (sample - estimate->second.srtt);
+    }
+    estimate->second.fresh = true;
+    m_samples++;
+  }
+
+  void Update() {
+    m_changes.clear();
+
+    for (std::pair<const std::size_t, Prefix>& prefix : m_prefixes) {
+      for (std::pair<const nfd::FaceId, Estimate>& face : prefix.second.faces) {
+        Estimate& estimate = face.second;
+        if (!estimate.fresh) {
+          continue;
+        }
+        estimate.fresh = false;
+
+        uint64_t cost = std::max<uint64_t>(1, std::llround(estimate.srtt));
+        double delta = std::abs(static_cast<double>(cost) - static_cast<double>(estimate.installed));
+        if (delta < 1 || (estimate.installed != 0 && delta <= m_config.hysteresis * estimate.installed)) {
+          continue;
+        }
+        m_changes.push_back(Change{ delta, &prefix.second, face.first, cost });
+      }
+    }
+
+    if (m_changes.size() > m_config.maxUpdates) {
+      std::partial_sort(m_changes.begin(), m_changes.begin() + m_config.maxUpdates, m_changes.end(),
+                        [](const Change& a, const Change& b) { return a.delta > b.delta; });
+      // what is left over stays fresh and competes again next period
+      for (auto i = m_changes.begin() + m_config.maxUpdates; i != m_changes.end(); i++) {
+        i->prefix->faces[i->face].fresh = true;
+      }
+      m_changes.resize(m_config.maxUpdates);
+    }
+
+    Ptr<L3Protocol> l3 = m_node->GetObject<L3Protocol>();
+    nfd::Fib& fib = m_forwarder->getFib();
+    for (const Change& change : m_changes) {
+      nfd::fib::Entry* entry = fib.findExactMatch(change.prefix->name);
+      Face* face = l3->getFaceTable().get(change.face);
+      if (entry == nullptr || face == nullptr || !entry->hasNextHop(*face)) {
+        change.prefix->faces.erase(change.face); // route or face went away
+        continue;
+      }
+      fib.addOrUpdateNextHop(*entry, *face, change.cost);
+      change.prefix->faces[change.face].installed = change.cost;
+      m_updates++;
+    }
+
+    m_event = Simulator::Schedule(m_config.period, &RttFibCost::Update, this);
+  }
+
+protected:
+  Ptr<Node> m_node;
+  Config m_config;
+  std::shared_ptr<nfd::Forwarder> m_forwarder;
+  EventId m_event;
+
+  std::unordered_map<std::size_t, Pending> m_pending; // (name, face) hash -> last transmission
+  std::size_t m_purgeAt;
+  std::unordered_map<std::size_t, Prefix> m_prefixes; // FIB prefix hash -> estimates
+  std::vector<Change> m_changes;                      // reused by every Update
+
+  uint64_t m_samples;
+  uint64_t m_updates;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_NDN_RTT_FIB_COST_HPP
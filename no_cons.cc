@@ -16,6 +16,8 @@
 #include "ns3/ndnSIM/utils/tracers/ndn-cs-tracer.hpp"
 #include "ns3/ndnSIM/utils/tracers/ndn-app-delay-tracer.hpp"
 
+#include "ndn-rtt-fib-cost.hpp"
+
 #include <memory>
 #include <iostream>
 #include <vector>
@@ -192,7 +194,11 @@ namespace run {
     prdStkHlper.Install(prodCont);
   }
 
-  void AddRoutingInfo() {
+  /**
+   * \brief allPossibleRoutes installs every face towards an origin, ranked by cost, instead
+   * of the single best one, so that costs changed later can change the forwarding choice
+  */
+  void AddRoutingInfo(bool allPossibleRoutes) {
     using helper::GetProducerAppPrefixes;
 
     ns3::ndn::GlobalRoutingHelper routingHelper;
@@ -205,7 +211,12 @@ namespace run {
       routingHelper.AddOrigin(str, ns3::NodeList::GetNode(5));
     }
 
-    routingHelper.CalculateRoutes();
+    if (allPossibleRoutes) {
+      routingHelper.CalculateAllPossibleRoutes();
+    }
+    else {
+      routingHelper.CalculateRoutes();
+    }
   }
 
   void InstallApplication() {
@@ -254,17 +265,22 @@ namespace run {
     }
   }
 
-  void InstallTracers() {
-    ns3::ndn::AppDelayTracer::InstallAll("./scratch/no-cons-app-delay.txt");
-    ns3::ndn::L3RateTracer::InstallAll("./scratch/no-cons-l3-tracer.txt");
-    ns3::ndn::CsTracer::InstallAll("./scratch/no-cons-cs-tracer.txt");
+  // suffix keeps the traces of different cost modes apart, to compare their throughput
+  void InstallTracers(const std::string& suffix) {
+    ns3::ndn::AppDelayTracer::InstallAll("./scratch/no-cons-app-delay" + suffix + ".txt");
+    ns3::ndn::L3RateTracer::InstallAll("./scratch/no-cons-l3-tracer" + suffix + ".txt");
+    ns3::ndn::CsTracer::InstallAll("./scratch/no-cons-cs-tracer" + suffix + ".txt");
   }
 
 }
 
 int main(int argc, char* argv[]) {
   std::unique_ptr<Parameters> param = std::make_unique<Parameters>();
+  bool rttCost = false; // FIB costs follow measured RTTs instead of the static link delays
+  bool allRoutes = false; // every route to an origin; implied by rttCost, the baseline to compare it with
   ns3::CommandLine cmd;
+  cmd.AddValue("rttCost", "periodically set FIB next hop costs from measured per-face RTTs", rttCost);
+  cmd.AddValue("allRoutes", "install all possible routes instead of the best one per prefix", allRoutes);
   cmd.Parse(argc, argv);
 
   // cmd.PrintHelp(std::cout);
@@ -282,12 +298,23 @@ int main(int argc, char* argv[]) {
 
   run::SetConfig();
   run::SetTopology(std::move(param));
-  run::AddRoutingInfo();
+  run::AddRoutingInfo(allRoutes || rttCost);
   run::InstallApplication();
-  run::InstallTracers();
+  run::InstallTracers(rttCost ? "-rtt" : allRoutes ? "-all" : "");
+
+  if (rttCost) {
+    ns3::ndn::RttFibCost::InstallAll();
+  }
 
   ns3::Simulator::Stop(ns3::Seconds(helper::GetStopTime().value_or(60)));
   ns3::Simulator::Schedule(ns3::Seconds(10), periodicPrinter);
+  ns3::Simulator::Run();
+
+  if (rttCost) {
+    ns3::ndn::RttFibCost::PrintStats(std::cout);
+    ns3::ndn::RttFibCost::Destroy();
+  }
+  ns3::Simulator::Destroy();
 }
 
 /**
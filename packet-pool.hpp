@@ -0,0 +1,244 @@
+#ifndef NDNSIM_SCRATCH_PACKET_POOL_HPP
+#define NDNSIM_SCRATCH_PACKET_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/**
+ * \brief Size-class pool behind the global operator new/delete of a simulation
+ *
+ * ns3::Packet, its buffers and tags, ndn::Block wire buffers, Interest/Data objects and
+ * their shared_ptr control blocks are all allocated with plain operator new inside ns-3
+ * and ndn-cxx, so the pool sits there: exactly one translation unit of the program does
+ *
+ *     #define NDNSIM_PACKET_POOL_REPLACE_NEW
+ *     #include "packet-pool.hpp"
+ *
+ * (test1-pool.cc builds test1 this way; test1 itself keeps the stock allocator) and
+ * every allocation of at most MAX_SIZE bytes then goes to one of the size classes (16
+ * byte steps up to 256, coarser steps up to 4096, with 1280 and 1536 for Data with a
+ * 1024 byte payload). A class recycles freed blocks through a free list and carves new
+ * ones from CHUNK sized arenas, so once the simulation reaches steady state forwarding a
+ * packet costs no malloc at all. Larger allocations, and all allocations while the pool
+ * is disabled (SetEnabled, off by default), go to malloc; every block carries a 16 byte
+ * header naming its class, so enabling or disabling at any time is safe.
+ *
+ * Free lists and counters are thread_local: ns-3 runs the simulation on one thread and
+ * the counters reported by Collect are those of the calling thread. A block freed by
+ * another thread joins that thread's free list. Arena memory is never returned to the
+ * system.
+*/
+class PacketPool {
+public:
+  static constexpr std::size_t HEADER = 16; // keeps the default new alignment
+  static constexpr std::size_t MAX_SIZE = 4096;
+  static constexpr std::size_t CHUNK = 64 * 1024;
+  static constexpr uint32_t CLASSES = 28;
+
+  struct ClassStats {
+    std::size_t size;
+    uint64_t allocations;
+    uint64_t carved;     // blocks cut from arenas (the rest came from the free list)
+    uint64_t freeBlocks; // currently on the free list
+  };
+
+  struct Stats {
+    bool enabled;
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t pooled;     // allocations served from a free list
+    uint64_t mallocs;    // arenas plus allocations passed to malloc
+    uint64_t arenaBytes;
+    ClassStats classes[CLASSES];
+  };
+
+  static void SetEnabled(bool enabled) {
+    s_enabled = enabled;
+  }
+
+  static bool IsEnabled() {
+    return s_enabled;
+  }
+
+  /**
+   * \brief Fill out with the counters of the calling thread; makes no allocation
+  */
+  static void Collect(Stats& out) {
+    const State& state = t_state;
+    out.enabled = s_enabled;
+    out.allocations = state.allocations;
+    out.frees = state.frees;
+    out.pooled = state.pooled;
+    out.mallocs = state.mallocs;
+    out.arenaBytes = state.arenaBytes;
+    for (uint32_t c = 0; c < CLASSES; c++) {
+      out.classes[c] = ClassStats{ SIZES[c], state.classes[c].allocations, state.classes[c].carved,
+                                   state.classes[c].freeBlocks };
+    }
+  }
+
+  /**
+   * \returns nullptr when out of memory
+  */
+  static void* Allocate(std::size_t size) {
+    State& state = t_state;
+    state.allocations++;
+
+    if (s_enabled && size <= MAX_SIZE) {
+      uint32_t c = ClassOf(size);
+      Class& pool = state.classes[c];
+      pool.allocations++;
+
+      Header* header;
+      if (pool.free != nullptr) {
+        header = pool.free;
+        pool.free = *reinterpret_cast<Header**>(header + 1);
+        pool.freeBlocks--;
+        state.pooled++;
+      }
+      else {
+        std::size_t block = HEADER + SIZES[c];
+        if (static_cast<std::size_t>(pool.end - pool.cursor) < block) {
+          char* arena = static_cast<char*>(std::malloc(CHUNK));
+          if (arena == nullptr) {
+            return nullptr;
+          }
+          state.mallocs++;
+          state.arenaBytes += CHUNK;
+          pool.cursor = arena;
+          pool.end = arena + CHUNK;
+        }
+        header = reinterpret_cast<Header*>(pool.cursor);
+        pool.cursor += block;
+        pool.carved++;
+      }
+      header->cls = c;
+      return header + 1;
+    }
+
+    Header* header = static_cast<Header*>(std::malloc(HEADER + (size > 0 ? size : 1)));
+    if (header == nullptr) {
+      return nullptr;
+    }
+    state.mallocs++;
+    header->cls = HEAP;
+    return header + 1;
+  }
+
+  static void Free(void* p) {
+    if (p == nullptr) {
+      return;
+    }
+    State& state = t_state;
+    state.frees++;
+
+    Header* header = static_cast<Header*>(p) - 1;
+    if (header->cls == HEAP) {
+      std::free(header);
+      return;
+    }
+    Class& pool = state.classes[header->cls];
+    *reinterpret_cast<Header**>(p) = pool.free;
+    pool.free = header;
+    pool.freeBlocks++;
+  }
+
+private:
+  static constexpr uint32_t HEAP = 0xFFFFFFFF; // class of blocks from malloc
+
+  struct alignas(16) Header {
+    uint32_t cls;
+  };
+  static_assert(sizeof(Header) == HEADER, "header must keep the new alignment");
+
+  struct Class {
+    Header* free;       // next pointer stored in the user part of the block
+    char* cursor;       // unused part of the current arena
+    char* end;
+    uint64_t allocations;
+    uint64_t carved;
+    uint64_t freeBlocks;
+  };
+
+  // plain data only: constant initialized, so thread_local access needs no guard and the
+  // state outlives every static destructor that still frees memory
+  struct State {
+    Class classes[CLASSES];
+    uint64_t allocations;
+    uint64_t frees;
+    uint64_t pooled;
+    uint64_t mallocs;
+    uint64_t arenaBytes;
+  };
+
+  static constexpr std::size_t SIZES[CLASSES] = {
+    16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 256,
+    320, 384, 512, 640, 768, 1024, 1280, 1536, 2048, 2560, 3072, 4096
+  };
+
+  static uint32_t ClassOf(std::size_t size) {
+    if (size <= 256) {
+      return size <= 16 ? 0 : static_cast<uint32_t>((size - 1) / 16);
+    }
+    uint32_t c = 16;
+    while (SIZES[c] < size) {
+      c++;
+    }
+    return c;
+  }
+
+  static inline bool s_enabled = false;
+  static inline thread_local State t_state{};
+};
+
+#ifdef NDNSIM_PACKET_POOL_REPLACE_NEW
+
+void* operator new(std::size_t size) {
+  void* p = PacketPool::Allocate(size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return PacketPool::Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return PacketPool::Allocate(size);
+}
+
+void operator delete(void* p) noexcept {
+  PacketPool::Free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  PacketPool::Free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  PacketPool::Free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+  PacketPool::Free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+  PacketPool::Free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+  PacketPool::Free(p);
+}
+
+#endif // NDNSIM_PACKET_POOL_REPLACE_NEW
+
+#endif // NDNSIM_SCRATCH_PACKET_POOL_HPP
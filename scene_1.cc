@@ -25,6 +25,12 @@
 #include "ns3/ndnSIM/utils/tracers/custom-cs-tracer.hpp"
 #include "ns3/ndnSIM/utils/tracers/custom-fib-tracer.hpp"
 
+#include "ndn-bulk-stack-helper.hpp"
+#include "ndn-node-stats.hpp"
+#include "custom-pit-tracer.hpp"
+#include "custom-app-delay-aggregate-tracer.hpp"
+#include "ndn-cache-placement.hpp"
+
 #include <memory>
 #include <iostream>
 #include <vector>
@@ -87,19 +93,18 @@ void ShowAllNodeInfo(std::shared_ptr<std::ostream> os) {
 #define PRINTER(x) for(const std::string &s: x) {*os << s <<"\t"; }
 
   ns3::Ptr<ns3::Node> m_ptr;
-  ns3::Ptr<ns3::ndn::L3Protocol> m_l3p;
+  static ns3::ndn::stats::NodeStats m_stats;
 
   std::initializer_list<std::string> header = { "Id","Name","Ndn?","CsSize","Policy" };
   PRINTER(header); *os << "\n\n";
 
   for (ns3::NodeList::Iterator i = ns3::NodeList::Begin(); i != ns3::NodeList::End(); ++i) {
     m_ptr = *i;
+    ns3::ndn::stats::Collect(m_ptr, m_stats);
 
-    if (m_ptr->GetObject<ns3::ndn::L3Protocol>() != 0) {
-      m_l3p = m_ptr->GetObject<ns3::ndn::L3Protocol>();
-      const ns3::ndn::nfd::Cs& m_cs = m_l3p->getForwarder()->getCs();
+    if (m_stats.hasNdn) {
       header = { std::to_string(m_ptr->GetId()) , ns3::Names::FindName(m_ptr), "Y",
-      std::to_string(m_cs.getLimit()),std::string(m_cs.getPolicy()->getName()) };
+      std::to_string(m_stats.csLimit),std::string(m_stats.csPolicy) };
     }
     else {
       header = { std::to_string(m_ptr->GetId()),ns3::Names::FindName(m_ptr),"N","0","None" };
@@ -163,7 +168,9 @@ void ShowConsumerAppInfoOnNode(ns3::Ptr<ns3::Node> m_ptr) {
 int main(int argc, char* argv[]) {
   ns3::CommandLine cmd;
   uint8_t freq; // freqency of custom consumer
+  std::string placement; // cache placement on intermediate nodes, empty for plain lru
   cmd.AddValue<uint8_t>("freq", "frequency of the consumer", freq);
+  cmd.AddValue("placement", "cache placement on intermediate nodes: lce, lcd, probcache or betweenness", placement);
   cmd.PrintHelp(std::cout);
   cmd.Parse(argc, argv);
 
@@ -186,16 +193,24 @@ int main(int argc, char* argv[]) {
   // Install stack in producer node
   stackHelper.Install(nodes.Get(8));
 
-  // Install stack in all intermediate nodes
-  stackHelper.setCsSize(1000);
+  // Install stack in all intermediate nodes, timing each setup phase
+  ns3::ndn::BulkStackHelper bulkStackHelper;
+  bulkStackHelper.SetDefaultRoutes(true);
+  bulkStackHelper.setCsSize(1000);
+  bulkStackHelper.setPolicy("nfd::cs::lru");
+
+  ns3::NodeContainer intermediateNodes;
   int totalCount = nodes.GetN();
 
   for (int i = 0;i < totalCount;i++) {
     if (i != 0 && i != 8) {
-      stackHelper.Install(nodes.Get(i));
+      intermediateNodes.Add(nodes.Get(i));
     }
   }
 
+  bulkStackHelper.Install(intermediateNodes);
+  bulkStackHelper.PrintTimings(std::cout);
+
   // Worst idea, after calling the function, the variable is released 
   // So std::cout is released
   // So call empty function on free, thus std::cout is not affected
@@ -205,6 +220,13 @@ int main(int argc, char* argv[]) {
   ns3::ndn::GlobalRoutingHelper routingHelper;
   routingHelper.InstallAll(); // Install in all nodes as we are sure that all nodes have ndn stack installed
 
+  // after the routing helper, betweenness is computed from its adjacencies
+  if (!placement.empty()) {
+    ns3::ndn::CachePlacementHelper placementHelper;
+    placementHelper.SetMode(placement);
+    placementHelper.Install(intermediateNodes);
+  }
+
 
   // Set strategy choice on all nodes
   // access strategy is a dynamic update strategy
@@ -267,6 +289,14 @@ int main(int argc, char* argv[]) {
   ns3::ndn::AppDelayTracer::InstallAll("./scratch/scene_1-appdelay-tracer.txt");
   ns3::ndn::custom::CsTracer::InstallAll("./scratch/scene_1-custom-cs-tracer.txt");
   ns3::ndn::custom::FibTracer::InstallAll("./scratch/scene_1-custom-fib-tracer.txt");
+  ns3::ndn::custom::PitTracer::InstallAll("./scratch/scene_1-custom-pit-tracer.txt");
+
+  // only the prefix_1 consumers (edge nodes 0 and 2), no hooks anywhere else
+  ns3::NodeContainer prefix1Edges;
+  prefix1Edges.Add(nodes.Get(0));
+  prefix1Edges.Add(nodes.Get(2));
+  ns3::ndn::custom::AppDelayAggregateTracer::Install(prefix1Edges, "./scratch/scene_1-prefix_1-delay-tracer.txt",
+    ns3::Seconds(1), ns3::ndn::custom::TraceFilter("prefix_1"));
 
   routingHelper.CalculateAllPossibleRoutes();
 
@@ -280,5 +310,8 @@ int main(int argc, char* argv[]) {
 
   ns3::Simulator::Stop(ns3::Seconds(55));
   ns3::Simulator::Run();
+  if (!placement.empty()) {
+    ns3::ndn::CachePlacementHelper::PrintStats(std::cout);
+  }
   ns3::Simulator::Destroy();
 }
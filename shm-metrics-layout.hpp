@@ -0,0 +1,156 @@
+#ifndef NDNSIM_SCRATCH_SHM_METRICS_LAYOUT_HPP
+#define NDNSIM_SCRATCH_SHM_METRICS_LAYOUT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * \brief Layout of the live metrics shared-memory segment
+ *
+ * Shared between the simulation side (custom-shm-metrics-exporter.hpp) and external
+ * readers (shm-metrics-reader.cc), so it only uses fixed-width types and no ns-3 headers.
+ *
+ *     ShmHeader | slot 0 | slot 1 | ... | slot slotCount-1
+ *
+ * Every slot is one snapshot of all nodes:
+ *
+ *     ShmSlotHeader | ShmNodeRecord x nodeCapacity | ShmFaceRecord x nodeCapacity * faceCapacity
+ *
+ * Slots form a ring written round robin. Each slot is guarded by its own seqlock: the
+ * writer makes seq odd, writes, then makes it even again; a reader copies the slot and
+ * keeps the copy only if seq was even and unchanged around the copy. The writer never
+ * waits for readers, readers never block the writer.
+ *
+ * Counters are cumulative since the start of the run; rates are the difference of two
+ * snapshots divided by the difference of their times.
+*/
+
+namespace ns3 {
+namespace ndn {
+namespace shm {
+
+constexpr uint32_t MAGIC = 0x4e444d53; // "SMDN"
+constexpr uint32_t VERSION = 1;
+
+struct ShmHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t nodeCapacity;
+  uint32_t faceCapacity;
+  uint32_t slotCount;
+  uint32_t slotSize;
+  std::atomic<uint64_t> published; // snapshots written so far; the latest is (published - 1) % slotCount
+};
+
+struct ShmSlotHeader {
+  std::atomic<uint64_t> seq;
+  double time; // simulation time in seconds
+  uint32_t nNodes;
+  uint32_t padding;
+};
+
+struct ShmNodeRecord {
+  uint32_t nodeId;
+  uint32_t nFaces; // entries of this node's face records that are filled
+  uint64_t csSize;
+  uint64_t csHits;
+  uint64_t csMisses;
+  uint64_t pitSize;
+  uint64_t l2Drops; // transmit drops (queue full, link down) over all net devices of the node
+};
+
+struct ShmFaceRecord {
+  uint64_t faceId;
+  uint64_t nInInterests;
+  uint64_t nOutInterests;
+  uint64_t nInData;
+  uint64_t nOutData;
+  uint64_t nInNacks;
+  uint64_t nOutNacks;
+  uint64_t nInBytes;  // L3 bytes
+  uint64_t nOutBytes;
+  uint64_t l2TxBytes; // bytes sent by the net device under the face, 0 for app faces
+  uint64_t l2Drops;
+};
+
+inline std::size_t SlotSize(uint32_t nodeCapacity, uint32_t faceCapacity) {
+  std::size_t size = sizeof(ShmSlotHeader) + sizeof(ShmNodeRecord) * nodeCapacity
+                     + sizeof(ShmFaceRecord) * nodeCapacity * faceCapacity;
+  return (size + 63) & ~static_cast<std::size_t>(63);
+}
+
+inline std::size_t SegmentSize(uint32_t nodeCapacity, uint32_t faceCapacity, uint32_t slotCount) {
+  return ((sizeof(ShmHeader) + 63) & ~static_cast<std::size_t>(63))
+         + SlotSize(nodeCapacity, faceCapacity) * slotCount;
+}
+
+inline uint8_t* Slot(ShmHeader* header, uint64_t index) {
+  return reinterpret_cast<uint8_t*>(header) + ((sizeof(ShmHeader) + 63) & ~static_cast<std::size_t>(63))
+         + static_cast<std::size_t>(header->slotSize) * (index % header->slotCount);
+}
+
+inline ShmSlotHeader* SlotHeader(uint8_t* slot) {
+  return reinterpret_cast<ShmSlotHeader*>(slot);
+}
+
+inline ShmNodeRecord* Nodes(uint8_t* slot) {
+  return reinterpret_cast<ShmNodeRecord*>(slot + sizeof(ShmSlotHeader));
+}
+
+inline ShmFaceRecord* Faces(uint8_t* slot, const ShmHeader* header, uint32_t node) {
+  return reinterpret_cast<ShmFaceRecord*>(slot + sizeof(ShmSlotHeader)
+                                          + sizeof(ShmNodeRecord) * header->nodeCapacity)
+         + static_cast<std::size_t>(node) * header->faceCapacity;
+}
+
+/**
+ * \brief Writer side: open the slot for writing (seq becomes odd)
+*/
+inline void BeginWrite(ShmSlotHeader* slot) {
+  slot->seq.store(slot->seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+/**
+ * \brief Writer side: close the slot (seq becomes even) and advance the ring
+*/
+inline void EndWrite(ShmHeader* header, ShmSlotHeader* slot) {
+  slot->seq.store(slot->seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  header->published.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * \brief Reader side: copy the most recent complete snapshot into out (slotSize bytes)
+ * \returns false if nothing was published yet or the writer kept overwriting the slot
+*/
+inline bool ReadLatest(ShmHeader* header, uint8_t* out, int retries = 16) {
+  for (int attempt = 0; attempt < retries; attempt++) {
+    uint64_t published = header->published.load(std::memory_order_acquire);
+    if (published == 0) {
+      return false;
+    }
+
+    uint8_t* slot = Slot(header, published - 1);
+    ShmSlotHeader* slotHeader = SlotHeader(slot);
+    uint64_t before = slotHeader->seq.load(std::memory_order_acquire);
+    if (before & 1) {
+      continue;
+    }
+    // seq is not copied, out only carries the payload behind it
+    std::memcpy(out + sizeof(std::atomic<uint64_t>), slot + sizeof(std::atomic<uint64_t>),
+                header->slotSize - sizeof(std::atomic<uint64_t>));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slotHeader->seq.load(std::memory_order_relaxed) == before) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace shm
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_SCRATCH_SHM_METRICS_LAYOUT_HPP
@@ -0,0 +1,193 @@
+/**
+ * Live viewer for the segment written by custom-shm-metrics-exporter.hpp
+ *
+ * Attaches read-only, never blocks the simulation and only needs shm-metrics-layout.hpp.
+ *
+ *     shm-metrics-reader [--name=/ndnsim-metrics] [--interval=1000] [--faces] [--count=N]
+ *
+ * Every interval the latest snapshot is copied out of the ring and compared with the
+ * previous one; rates are per second of simulation time. With --faces one line per
+ * face is printed instead of one per node.
+ */
+
+#include "shm-metrics-layout.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ns3::ndn::shm;
+
+namespace {
+
+double
+Rate(uint64_t now, uint64_t before, double dt)
+{
+  return dt > 0 && now >= before ? (now - before) / dt : 0;
+}
+
+const ShmFaceRecord*
+FindFace(uint8_t* slot, const ShmHeader* header, uint32_t node, uint64_t faceId)
+{
+  const ShmNodeRecord& record = Nodes(slot)[node];
+  const ShmFaceRecord* faces = Faces(slot, header, node);
+  for (uint32_t f = 0; f < record.nFaces; f++) {
+    if (faces[f].faceId == faceId) {
+      return &faces[f];
+    }
+  }
+  return nullptr;
+}
+
+void
+PrintNodes(uint8_t* now, uint8_t* before, const ShmHeader* header, double dt)
+{
+  std::printf("%8s %8s %10s %10s %10s %12s %12s %10s\n", "Time", "Node", "PitSize", "CsHit/s",
+              "CsMiss/s", "InInt/s", "OutData/s", "L2Drop/s");
+
+  const ShmSlotHeader* slot = SlotHeader(now);
+  for (uint32_t n = 0; n < slot->nNodes; n++) {
+    const ShmNodeRecord& cur = Nodes(now)[n];
+    const ShmNodeRecord& prev = Nodes(before)[n];
+
+    uint64_t inInterests = 0, outData = 0, prevInInterests = 0, prevOutData = 0;
+    for (uint32_t f = 0; f < cur.nFaces; f++) {
+      const ShmFaceRecord& face = Faces(now, header, n)[f];
+      inInterests += face.nInInterests;
+      outData += face.nOutData;
+      const ShmFaceRecord* old = FindFace(before, header, n, face.faceId);
+      if (old != nullptr) {
+        prevInInterests += old->nInInterests;
+        prevOutData += old->nOutData;
+      }
+    }
+
+    std::printf("%8.2f %8u %10llu %10.1f %10.1f %12.1f %12.1f %10.1f\n", slot->time, cur.nodeId,
+                static_cast<unsigned long long>(cur.pitSize), Rate(cur.csHits, prev.csHits, dt),
+                Rate(cur.csMisses, prev.csMisses, dt), Rate(inInterests, prevInInterests, dt),
+                Rate(outData, prevOutData, dt), Rate(cur.l2Drops, prev.l2Drops, dt));
+  }
+}
+
+void
+PrintFaces(uint8_t* now, uint8_t* before, const ShmHeader* header, double dt)
+{
+  std::printf("%8s %8s %6s %10s %10s %10s %10s %12s %12s %10s\n", "Time", "Node", "Face", "InInt/s",
+              "OutInt/s", "InData/s", "OutData/s", "L3Out kB/s", "L2Tx kB/s", "L2Drop/s");
+
+  const ShmSlotHeader* slot = SlotHeader(now);
+  for (uint32_t n = 0; n < slot->nNodes; n++) {
+    const ShmNodeRecord& cur = Nodes(now)[n];
+    for (uint32_t f = 0; f < cur.nFaces; f++) {
+      const ShmFaceRecord& face = Faces(now, header, n)[f];
+      ShmFaceRecord old = {};
+      const ShmFaceRecord* found = FindFace(before, header, n, face.faceId);
+      if (found != nullptr) {
+        old = *found;
+      }
+
+      std::printf("%8.2f %8u %6llu %10.1f %10.1f %10.1f %10.1f %12.2f %12.2f %10.1f\n", slot->time,
+                  cur.nodeId, static_cast<unsigned long long>(face.faceId),
+                  Rate(face.nInInterests, old.nInInterests, dt), Rate(face.nOutInterests, old.nOutInterests, dt),
+                  Rate(face.nInData, old.nInData, dt), Rate(face.nOutData, old.nOutData, dt),
+                  Rate(face.nOutBytes, old.nOutBytes, dt) / 1000, Rate(face.l2TxBytes, old.l2TxBytes, dt) / 1000,
+                  Rate(face.l2Drops, old.l2Drops, dt));
+    }
+  }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::string name = "/ndnsim-metrics";
+  int intervalMs = 1000;
+  bool faces = false;
+  long count = -1;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 7, "--name=") == 0) {
+      name = arg.substr(7);
+    }
+    else if (arg.compare(0, 11, "--interval=") == 0) {
+      intervalMs = std::atoi(arg.c_str() + 11);
+    }
+    else if (arg.compare(0, 8, "--count=") == 0) {
+      count = std::atol(arg.c_str() + 8);
+    }
+    else if (arg == "--faces") {
+      faces = true;
+    }
+    else {
+      std::fprintf(stderr, "usage: %s [--name=/ndnsim-metrics] [--interval=ms] [--faces] [--count=N]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    std::fprintf(stderr, "Shared memory %s not found: %s\n", name.c_str(), std::strerror(errno));
+    return 1;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(ShmHeader)) {
+    std::fprintf(stderr, "Shared memory %s is not initialized\n", name.c_str());
+    return 1;
+  }
+  void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    std::fprintf(stderr, "Shared memory %s cannot be mapped: %s\n", name.c_str(), std::strerror(errno));
+    return 1;
+  }
+
+  // the mapping is read-only; the atomics are only loaded
+  ShmHeader* header = static_cast<ShmHeader*>(addr);
+  if (header->magic != MAGIC || header->version != VERSION
+      || SegmentSize(header->nodeCapacity, header->faceCapacity, header->slotCount)
+           > static_cast<std::size_t>(st.st_size)) {
+    std::fprintf(stderr, "Shared memory %s has an unknown layout\n", name.c_str());
+    return 1;
+  }
+
+  std::vector<uint8_t> current(header->slotSize);
+  std::vector<uint8_t> previous(header->slotSize);
+  bool havePrevious = false;
+
+  for (long printed = 0; count < 0 || printed < count;) {
+    if (ReadLatest(header, current.data())) {
+      double dt = havePrevious ? SlotHeader(current.data())->time - SlotHeader(previous.data())->time : 0;
+      if (dt > 0) {
+        if (faces) {
+          PrintFaces(current.data(), previous.data(), header, dt);
+        }
+        else {
+          PrintNodes(current.data(), previous.data(), header, dt);
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+        printed++;
+      }
+      if (!havePrevious || dt > 0) {
+        current.swap(previous);
+        havePrevious = true;
+      }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+  }
+
+  munmap(addr, st.st_size);
+  return 0;
+}
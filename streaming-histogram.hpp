@@ -0,0 +1,114 @@
+#ifndef NDNSIM_SCRATCH_STREAMING_HISTOGRAM_HPP
+#define NDNSIM_SCRATCH_STREAMING_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * \brief Fixed-memory log-linear histogram (HDR style) for streaming quantiles
+ *
+ * Values are non-negative integers (e.g. microseconds). Every power of two is split
+ * into 64 linear sub-buckets, so a quantile is within 1/64 (~1.6%) of the true value;
+ * values below 128 are exact. The range is capped at 2^40, larger values fall into the
+ * last bucket. Recording is O(1), a quantile query scans the ~2300 counters.
+*/
+class LogHistogram {
+public:
+  static constexpr int SUB_BITS = 6;
+  static constexpr uint32_t SUB_COUNT = 1u << SUB_BITS;
+  static constexpr int MAX_BITS = 40;
+  static constexpr uint32_t BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+
+  LogHistogram() {
+    Reset();
+  }
+
+  void Reset() {
+    m_counts.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+  }
+
+  void Record(uint64_t value) {
+    m_counts[Index(value)]++;
+    m_count++;
+    m_sum += value;
+    m_max = std::max(m_max, value);
+  }
+
+  /**
+   * \brief Smallest recorded value v such that a fraction q of the values is <= v
+   * (reported as the middle of its bucket)
+  */
+  uint64_t Quantile(double q) const {
+    if (m_count == 0) {
+      return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(q * m_count));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < BUCKETS; i++) {
+      seen += m_counts[i];
+      if (seen >= rank) {
+        return std::min(Midpoint(i), m_max);
+      }
+    }
+    return m_max;
+  }
+
+  uint64_t GetCount() const {
+    return m_count;
+  }
+
+  double GetMean() const {
+    return m_count == 0 ? 0 : static_cast<double>(m_sum) / m_count;
+  }
+
+  uint64_t GetMax() const {
+    return m_max;
+  }
+
+  void Merge(const LogHistogram& other) {
+    for (uint32_t i = 0; i < BUCKETS; i++) {
+      m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_max = std::max(m_max, other.m_max);
+  }
+
+private:
+  static uint32_t Index(uint64_t value) {
+    if (value < 2 * SUB_COUNT) {
+      return static_cast<uint32_t>(value);
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - SUB_BITS;
+    if (msb >= MAX_BITS) {
+      return BUCKETS - 1;
+    }
+    return static_cast<uint32_t>((shift + 1) * SUB_COUNT + (value >> shift) - SUB_COUNT);
+  }
+
+  static uint64_t Midpoint(uint32_t index) {
+    if (index < 2 * SUB_COUNT) {
+      return index;
+    }
+    int shift = index / SUB_COUNT - 1;
+    uint64_t lower = static_cast<uint64_t>(index % SUB_COUNT + SUB_COUNT) << shift;
+    return lower + (uint64_t(1) << shift) / 2;
+  }
+
+private:
+  std::array<uint32_t, BUCKETS> m_counts;
+  uint64_t m_count;
+  uint64_t m_sum;
+  uint64_t m_max;
+};
+
+#endif // NDNSIM_SCRATCH_STREAMING_HISTOGRAM_HPP
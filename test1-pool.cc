@@ -0,0 +1,10 @@
+/**
+ * test1 with the global operator new/delete replaced by PacketPool
+ *
+ * Recycling is enabled with --packetPool; without it allocations still go through the
+ * pool's 16 byte header and counters, so baseline memory and timing are measured with
+ * test1, which keeps the stock allocator.
+*/
+
+#define NDNSIM_PACKET_POOL_REPLACE_NEW
+#include "test1.cc"
@@ -2,15 +2,52 @@
 #include "ns3/network-module.h"
 #include "ns3/ndnSIM-module.h"
 
+#include "ideal-link.hpp"
+#include "ndn-direct-link.hpp"
+#include "custom-shm-metrics-exporter.hpp"
+#include "custom-memory-accounting.hpp"
+#include "custom-popularity-tracer.hpp"
+#include "ndn-node-stats-format.hpp"
+
+// operator new/delete only go through PacketPool in the test1-pool build, which defines
+// NDNSIM_PACKET_POOL_REPLACE_NEW; this one keeps the stock allocator
+#include "packet-pool.hpp"
+
 namespace ns3 {
 
 int
 main(int argc, char* argv[])
 {
+  bool idealLinks = false;
+  std::string shmMetrics;
+#ifdef NDNSIM_PACKET_POOL_REPLACE_NEW
+  bool packetPool = false;
+#endif
+  bool directLinks = false;
+  std::string memoryAccounting;
+  bool popularity = false;
+
   CommandLine cmd;
+  cmd.AddValue("idealLinks", "Use analytic ideal links instead of PointToPoint links", idealLinks);
+  cmd.AddValue("shmMetrics", "Publish live counters into this shared-memory segment (e.g. /ndnsim-metrics)", shmMetrics);
+#ifdef NDNSIM_PACKET_POOL_REPLACE_NEW
+  cmd.AddValue("packetPool", "Recycle packet, buffer and block allocations through size-class pools", packetPool);
+#endif
+  cmd.AddValue("directLinks", "Pass decoded packets over the ideal links instead of encoding them (with idealLinks)",
+    directLinks);
+  cmd.AddValue("memoryAccounting", "Write per-node memory accounting and peaks to this file (- for stdout)",
+    memoryAccounting);
+  cmd.AddValue("popularity", "Trace the top names and prefixes of interests and CS hits per node", popularity);
   cmd.Parse(argc, argv);
 
-  AnnotatedTopologyReader topologyReader("", 10);
+#ifdef NDNSIM_PACKET_POOL_REPLACE_NEW
+  PacketPool::SetEnabled(packetPool);
+#endif
+
+  // Ideal links model bandwidth and delay with one event per packet per hop
+  AnnotatedTopologyReader p2pReader("", 10);
+  IdealLinkTopologyReader idealReader("", 10);
+  AnnotatedTopologyReader& topologyReader = idealLinks ? idealReader : p2pReader;
   topologyReader.SetFileName("src/ndnSIM/examples/topologies/topo-tree-25-node.txt");
   topologyReader.Read();
 
@@ -19,6 +56,14 @@ main(int argc, char* argv[])
   ndn::StackHelper ndnHelper;
   ndnHelper.setPolicy("nfd::cs::lru");
   ndnHelper.setCsSize(1000);
+  if (directLinks && idealLinks) {
+    ndn::DirectLinkHelper::Install(ndnHelper);
+    // the exporter publishes device and face byte counters, which passed-through packets skip
+    ndn::DirectLinkService::SetBytesNeeded(!shmMetrics.empty());
+    if (!shmMetrics.empty()) {
+      std::cerr << "shmMetrics needs link bytes: directLinks sends every packet encoded\n";
+    }
+  }
   ndnHelper.InstallAll();
   /****************************************************************************/
   // Installing global routing interface on all nodes
@@ -131,8 +176,43 @@ main(int argc, char* argv[])
   // Tracer:
 
   L2RateTracer::InstallAll("./scratch/test1-drop-trace.txt", Seconds(0.5));
+  if (popularity) {
+    ndn::custom::PopularityTracer::InstallAll("./scratch/test1-popularity-trace.txt", Seconds(1.0), 10, 1);
+  }
+  if (!shmMetrics.empty()) {
+    // watch with: shm-metrics-reader --name=<segment>
+    ndn::custom::ShmMetricsExporter::Install(shmMetrics, Seconds(0.5));
+  }
+  if (!memoryAccounting.empty()) {
+    // summary written by Simulator::Destroy
+    ndn::custom::MemoryAccounting::Install(memoryAccounting, Seconds(0.1));
+  }
+
+#ifdef NDNSIM_PACKET_POOL_REPLACE_NEW
+  ndn::stats::PoolStats poolBefore, poolAfter;
+  ndn::stats::CollectPool(poolBefore);
+#endif
 
   Simulator::Run();
+
+#ifdef NDNSIM_PACKET_POOL_REPLACE_NEW
+  // the pool counters only see allocations in the pooled build
+  ndn::stats::CollectPool(poolAfter);
+  uint64_t forwarded = 0;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    const nfd::ForwarderCounters& counters = (*node)->GetObject<ndn::L3Protocol>()->getForwarder()->getCounters();
+    forwarded += counters.nOutInterests + counters.nOutData;
+  }
+  ndn::stats::WriteText(std::cout, poolAfter);
+  std::cout << "Mallocs per forwarded packet : "
+            << (forwarded > 0 ? static_cast<double>(poolAfter.mallocs - poolBefore.mallocs) / forwarded : 0) << "\n";
+#endif
+
+  if (directLinks && idealLinks) {
+    ndn::DirectLinkHelper::PrintStats(std::cout);
+  }
+
+  ndn::custom::ShmMetricsExporter::Destroy();
   Simulator::Destroy();
 
   return 0;
@@ -0,0 +1,977 @@
+/**
+ * Parallel join of the text traces written by a scenario
+ *
+ *     trace-merge [--threads=N] [--period=1] [--out=trace-merge] [--sum=Col,...] [--mean=Col,...]
+ *                 [label=]<trace> ...
+ *
+ * Every trace is a tab separated table with a header line, as written by CsTracer,
+ * L3RateTracer, AppDelayTracer, L2RateTracer and the custom:: tracers. Columns are found
+ * by their header name:
+ *
+ * - Time: binned to the end of its --period interval (records without it only count in
+ *   the summaries)
+ * - Node
+ * - FaceId or Face (joined as is), Interface (L2 devices, joined as "if<N>")
+ * - Type: becomes part of the metric name
+ * - Prefix
+ * - AppId and SeqNo are ignored, every other numeric column is a metric named
+ *   "<label>.<Type>.<Column>" (label defaults to the file name without extension)
+ *
+ * Files are mapped and cut into chunks at line boundaries; each thread parses chunks
+ * into its own tables, which are merged at the end. Four files are written:
+ *
+ *     <out>-series.txt          Time Node Face <metric>...   joined on (time, node, face)
+ *     <out>-prefix-series.txt   Time Prefix <metric>...
+ *     <out>-nodes.txt           Node Metric Records Total Mean Max
+ *     <out>-prefixes.txt        Prefix Metric Records Total Mean Max
+ *
+ * In the series a cell is the sum of the records of the bin for count columns (Packets,
+ * Kilobytes, Count, ...; see --sum) and their mean for everything else (delays, windows,
+ * percentiles, queue lengths; see --mean). In a file with a *Raw column (L3RateTracer,
+ * L2RateTracer) Packets and Kilobytes are per-second rates and are averaged too; the
+ * counts are in the *Raw columns. Cells without records are left empty, and so is the
+ * Total of the summaries for averaged metrics.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t CHUNK = 1 << 20;
+constexpr int64_t NO_TIME = std::numeric_limits<int64_t>::min();
+constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+/**
+ * \brief Column roles of one trace, from its header line
+ */
+struct Schema {
+  int time = -1;
+  int node = -1;
+  int face = -1;
+  int type = -1;
+  int prefix = -1;
+  bool interface = false; // face column is an L2 interface index
+  std::vector<std::string> columns;
+  std::vector<bool> metric;
+  std::vector<bool> count; // metric summed per bin rather than averaged
+};
+
+struct Input {
+  std::string label;
+  std::string path;
+  const char* data = nullptr;
+  std::size_t size = 0;
+  std::size_t body = 0; // offset of the first line after the header
+  Schema schema;
+};
+
+struct Chunk {
+  uint32_t input;
+  std::size_t begin;
+  std::size_t end;
+};
+
+struct Acc {
+  double sum = 0;
+  double max = -std::numeric_limits<double>::infinity();
+  uint64_t count = 0;
+
+  void Add(double value) {
+    sum += value;
+    max = std::max(max, value);
+    count++;
+  }
+
+  void Merge(const Acc& other) {
+    sum += other.sum;
+    max = std::max(max, other.max);
+    count += other.count;
+  }
+};
+
+struct SeriesKey {
+  int64_t bin;
+  uint32_t node;
+  uint32_t face;
+  uint32_t metric;
+
+  bool operator==(const SeriesKey& other) const {
+    return bin == other.bin && node == other.node && face == other.face && metric == other.metric;
+  }
+};
+
+struct PrefixKey {
+  int64_t bin;
+  uint32_t prefix;
+  uint32_t metric;
+
+  bool operator==(const PrefixKey& other) const {
+    return bin == other.bin && prefix == other.prefix && metric == other.metric;
+  }
+};
+
+inline uint64_t
+Mix(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return h;
+}
+
+struct SeriesHash {
+  std::size_t operator()(const SeriesKey& k) const {
+    return Mix(static_cast<uint64_t>(k.bin) * 0x9e3779b97f4a7c15ULL ^ (static_cast<uint64_t>(k.node) << 32 | k.face)
+               ^ static_cast<uint64_t>(k.metric) << 17);
+  }
+};
+
+struct PrefixHash {
+  std::size_t operator()(const PrefixKey& k) const {
+    return Mix(static_cast<uint64_t>(k.bin) * 0x9e3779b97f4a7c15ULL ^ (static_cast<uint64_t>(k.prefix) << 32 | k.metric));
+  }
+};
+
+/**
+ * \brief Hash map with the entries in one vector, in insertion order
+ *
+ * Open addressing over a power of two slot table; a slot holds the upper hash bits and
+ * index + 1 of the entry (0 when empty), so most probes do not touch the entries.
+ */
+template<typename Key, typename Value, typename Hash>
+class FlatMap {
+public:
+  typedef typename std::vector<std::pair<Key, Value>>::const_iterator const_iterator;
+
+  Value& operator[](const Key& key) {
+    if (2 * (m_entries.size() + 1) > m_slots.size()) {
+      Grow();
+    }
+    uint64_t hash = Hash()(key);
+    uint64_t tag = hash >> 32 << 32;
+    for (std::size_t i = hash & (m_slots.size() - 1);; i = (i + 1) & (m_slots.size() - 1)) {
+      uint64_t slot = m_slots[i];
+      if (slot == 0) {
+        m_entries.emplace_back(key, Value());
+        m_slots[i] = tag | m_entries.size();
+        return m_entries.back().second;
+      }
+      if ((slot >> 32 << 32) == tag && m_entries[(slot & 0xFFFFFFFF) - 1].first == key) {
+        return m_entries[(slot & 0xFFFFFFFF) - 1].second;
+      }
+    }
+  }
+
+  const_iterator begin() const {
+    return m_entries.begin();
+  }
+
+  const_iterator end() const {
+    return m_entries.end();
+  }
+
+  std::size_t size() const {
+    return m_entries.size();
+  }
+
+private:
+  void Grow() {
+    std::vector<uint64_t> slots(std::max<std::size_t>(1024, 2 * m_slots.size()), 0);
+    for (std::size_t e = 0; e < m_entries.size(); e++) {
+      uint64_t hash = Hash()(m_entries[e].first);
+      std::size_t i = hash & (slots.size() - 1);
+      while (slots[i] != 0) {
+        i = (i + 1) & (slots.size() - 1);
+      }
+      slots[i] = hash >> 32 << 32 | (e + 1);
+    }
+    m_slots.swap(slots);
+  }
+
+private:
+  std::vector<uint64_t> m_slots;
+  std::vector<std::pair<Key, Value>> m_entries;
+};
+
+/**
+ * \brief Dense ids for strings; views must outlive the interner
+ */
+class Interner {
+public:
+  uint32_t Id(std::string_view s) {
+    auto id = m_ids.emplace(s, static_cast<uint32_t>(m_names.size()));
+    if (id.second) {
+      m_names.push_back(s);
+      m_hashes.push_back(std::hash<std::string_view>()(s));
+    }
+    return id.first->second;
+  }
+
+  std::string_view Name(uint32_t id) const {
+    return m_names[id];
+  }
+
+  /**
+   * \brief Hash of the string, the same in every Interner
+   */
+  uint64_t Hash(uint32_t id) const {
+    return m_hashes[id];
+  }
+
+  std::size_t Size() const {
+    return m_names.size();
+  }
+
+private:
+  std::unordered_map<std::string_view, uint32_t> m_ids;
+  std::vector<std::string_view> m_names;
+  std::vector<uint64_t> m_hashes;
+};
+
+/**
+ * \brief Number at the start of [pos, end), as printed by ostream (sign, digits,
+ * fraction, exponent)
+ * \returns false if the field is not a number
+ */
+bool
+ParseNumber(const char* pos, const char* end, double& out)
+{
+  bool negative = false;
+  if (pos < end && (*pos == '-' || *pos == '+')) {
+    negative = *pos == '-';
+    pos++;
+  }
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  int digits = 0;
+  for (; pos < end && *pos >= '0' && *pos <= '9'; pos++, digits++) {
+    if (mantissa < 100000000000000000ULL) {
+      mantissa = mantissa * 10 + (*pos - '0');
+    }
+    else {
+      exponent++;
+    }
+  }
+  if (pos < end && *pos == '.') {
+    for (pos++; pos < end && *pos >= '0' && *pos <= '9'; pos++, digits++) {
+      if (mantissa < 100000000000000000ULL) {
+        mantissa = mantissa * 10 + (*pos - '0');
+        exponent--;
+      }
+    }
+  }
+  if (digits == 0) {
+    return false;
+  }
+  if (pos < end && (*pos == 'e' || *pos == 'E')) {
+    pos++;
+    bool negativeExp = false;
+    if (pos < end && (*pos == '-' || *pos == '+')) {
+      negativeExp = *pos == '-';
+      pos++;
+    }
+    int e = 0;
+    if (pos == end || *pos < '0' || *pos > '9') {
+      return false;
+    }
+    for (; pos < end && *pos >= '0' && *pos <= '9'; pos++) {
+      e = std::min(e * 10 + (*pos - '0'), 10000);
+    }
+    exponent += negativeExp ? -e : e;
+  }
+  if (pos != end) {
+    return false;
+  }
+  double value = static_cast<double>(mantissa);
+  if (exponent != 0) {
+    value *= std::pow(10.0, exponent);
+  }
+  out = negative ? -value : value;
+  return true;
+}
+
+/**
+ * \brief Tables of one thread, with ids local to the thread
+ *
+ * The series are split into shards by bin and node (prefix) name, which do not depend on
+ * the local ids: a series lands in the same shard in every partial, so that the merge
+ * thread of a shard reads only that shard of each partial.
+ */
+struct Partial {
+  static constexpr uint32_t INTERFACE = 0x80000000; // face id bit of L2 interfaces
+
+  // strings view into the mapped files
+  Interner nodes, faces, interfaces, prefixes, types;
+  std::unordered_map<uint64_t, uint32_t> metricOf; // (input, type, column) -> metric
+  std::vector<uint64_t> metrics;
+  std::vector<FlatMap<SeriesKey, Acc, SeriesHash>> series;
+  std::vector<FlatMap<PrefixKey, Acc, PrefixHash>> prefixSeries;
+
+  explicit Partial(unsigned shards = 1)
+    : series(shards)
+    , prefixSeries(shards) {
+  }
+
+  static std::size_t Shard(int64_t bin, uint64_t name, std::size_t shards) {
+    return Mix(static_cast<uint64_t>(bin) * 0x9e3779b97f4a7c15ULL ^ name) % shards;
+  }
+
+  static uint64_t MetricKey(uint32_t input, uint32_t type, uint32_t column) {
+    return static_cast<uint64_t>(input) << 48 | static_cast<uint64_t>(column) << 32 | type;
+  }
+
+  uint32_t Metric(uint32_t input, uint32_t type, uint32_t column) {
+    uint64_t key = MetricKey(input, type, column);
+    auto metric = metricOf.emplace(key, static_cast<uint32_t>(metrics.size()));
+    if (metric.second) {
+      metrics.push_back(key);
+    }
+    return metric.first->second;
+  }
+
+  void Parse(uint32_t index, const Input& input, const char* pos, const char* end, double period) {
+    const Schema& schema = input.schema;
+    std::vector<std::string_view> fields;
+    fields.reserve(schema.columns.size());
+
+    while (pos < end) {
+      const char* eol = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+      if (eol == nullptr) {
+        eol = end;
+      }
+      const char* lineEnd = eol > pos && eol[-1] == '\r' ? eol - 1 : eol;
+
+      fields.clear();
+      for (const char* field = pos; field <= lineEnd;) {
+        const char* tab = static_cast<const char*>(std::memchr(field, '\t', lineEnd - field));
+        if (tab == nullptr) {
+          tab = lineEnd;
+        }
+        fields.emplace_back(field, tab - field);
+        field = tab + 1;
+      }
+      pos = eol + 1;
+
+      if (fields.size() < schema.columns.size()) {
+        continue; // blank or truncated line
+      }
+
+      int64_t bin = NO_TIME;
+      if (schema.time >= 0) {
+        double time;
+        const std::string_view& t = fields[schema.time];
+        if (!ParseNumber(t.data(), t.data() + t.size(), time)) {
+          continue; // repeated header
+        }
+        bin = static_cast<int64_t>(std::ceil(time / period - 1e-9));
+      }
+
+      uint32_t node = schema.node >= 0 ? nodes.Id(fields[schema.node]) : NONE;
+      uint32_t face = NONE;
+      if (schema.face >= 0) {
+        face = schema.interface ? interfaces.Id(fields[schema.face]) | INTERFACE : faces.Id(fields[schema.face]);
+      }
+      uint32_t type = schema.type >= 0 ? types.Id(fields[schema.type]) : NONE;
+      uint32_t prefix = schema.prefix >= 0 ? prefixes.Id(fields[schema.prefix]) : NONE;
+      FlatMap<SeriesKey, Acc, SeriesHash>& nodeShard =
+        series[Shard(bin, node != NONE ? nodes.Hash(node) : 0, series.size())];
+      FlatMap<PrefixKey, Acc, PrefixHash>& prefixShard =
+        prefixSeries[Shard(bin, prefix != NONE ? prefixes.Hash(prefix) : 0, prefixSeries.size())];
+
+      for (uint32_t c = 0; c < schema.columns.size(); c++) {
+        double value;
+        if (!schema.metric[c] || !ParseNumber(fields[c].data(), fields[c].data() + fields[c].size(), value)) {
+          continue;
+        }
+        uint32_t metric = Metric(index, type, c);
+        nodeShard[SeriesKey{ bin, node, face, metric }].Add(value);
+        if (prefix != NONE) {
+          prefixShard[PrefixKey{ bin, prefix, metric }].Add(value);
+        }
+      }
+    }
+  }
+};
+
+/**
+ * \brief Merged tables, with owned names
+ *
+ * The series keep the shards of the partial tables, so that every thread merges one
+ * shard from all of them.
+ */
+struct Merged {
+  std::vector<std::string> nodes, faces, prefixes, metrics;
+  std::vector<bool> counts; // per metric, from the schema of the first input having it
+  std::unordered_map<std::string, uint32_t> nodeIds, faceIds, prefixIds, metricIds;
+  std::vector<FlatMap<SeriesKey, Acc, SeriesHash>> series;
+  std::vector<FlatMap<PrefixKey, Acc, PrefixHash>> prefixSeries;
+
+  /**
+   * \brief Merged ids of the ids of one partial
+   */
+  struct Mapping {
+    std::vector<uint32_t> node, face, interface, prefix, metric;
+
+    uint32_t Face(uint32_t id) const {
+      if (id == NONE) {
+        return NONE;
+      }
+      return (id & Partial::INTERFACE) ? interface[id & ~Partial::INTERFACE] : face[id];
+    }
+  };
+
+  static uint32_t Id(const std::string& name, std::vector<std::string>& names,
+                     std::unordered_map<std::string, uint32_t>& ids) {
+    auto id = ids.emplace(name, static_cast<uint32_t>(names.size()));
+    if (id.second) {
+      names.push_back(name);
+    }
+    return id.first->second;
+  }
+
+  static void MapAll(const Interner& strings, const char* kind, std::vector<uint32_t>& out,
+                     std::vector<std::string>& names, std::unordered_map<std::string, uint32_t>& ids) {
+    out.resize(strings.Size());
+    for (uint32_t i = 0; i < strings.Size(); i++) {
+      out[i] = Id(kind + std::string(strings.Name(i)), names, ids);
+    }
+  }
+
+  Mapping Map(const Partial& partial, const std::vector<Input>& inputs) {
+    Mapping mapping;
+    MapAll(partial.nodes, "", mapping.node, nodes, nodeIds);
+    MapAll(partial.faces, "", mapping.face, faces, faceIds);
+    MapAll(partial.interfaces, "if", mapping.interface, faces, faceIds);
+    MapAll(partial.prefixes, "", mapping.prefix, prefixes, prefixIds);
+
+    for (uint64_t key : partial.metrics) {
+      const Input& input = inputs[key >> 48];
+      uint32_t type = static_cast<uint32_t>(key);
+      std::string name = input.label + ".";
+      if (type != NONE) {
+        name += std::string(partial.types.Name(type)) + ".";
+      }
+      uint32_t column = (key >> 32) & 0xFFFF;
+      name += input.schema.columns[column];
+      mapping.metric.push_back(Id(name, metrics, metricIds));
+      if (counts.size() < metrics.size()) {
+        counts.push_back(input.schema.count[column]);
+      }
+    }
+    return mapping;
+  }
+
+  void Merge(const std::vector<Partial>& partials, const std::vector<Input>& inputs, unsigned shards) {
+    std::vector<Mapping> mappings;
+    for (const Partial& partial : partials) {
+      mappings.push_back(Map(partial, inputs));
+    }
+
+    series.resize(shards);
+    prefixSeries.resize(shards);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < shards; t++) {
+      workers.emplace_back([&, t] {
+        for (std::size_t p = 0; p < partials.size(); p++) {
+          const Mapping& m = mappings[p];
+          for (const auto& entry : partials[p].series[t]) {
+            const SeriesKey& k = entry.first;
+            SeriesKey key{ k.bin, k.node == NONE ? NONE : m.node[k.node], m.Face(k.face), m.metric[k.metric] };
+            series[t][key].Merge(entry.second);
+          }
+          for (const auto& entry : partials[p].prefixSeries[t]) {
+            const PrefixKey& k = entry.first;
+            PrefixKey key{ k.bin, m.prefix[k.prefix], m.metric[k.metric] };
+            prefixSeries[t][key].Merge(entry.second);
+          }
+        }
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+};
+
+/**
+ * \brief Numbers in numeric order, then strings
+ */
+bool
+NaturalLess(const std::string& a, const std::string& b)
+{
+  char* endA;
+  char* endB;
+  double x = std::strtod(a.c_str(), &endA);
+  double y = std::strtod(b.c_str(), &endB);
+  bool numberA = !a.empty() && *endA == '\0';
+  bool numberB = !b.empty() && *endB == '\0';
+  if (numberA != numberB) {
+    return numberA;
+  }
+  if (numberA && x != y) {
+    return x < y;
+  }
+  return a < b;
+}
+
+/**
+ * \brief Rank of every name in natural order
+ */
+std::vector<uint32_t>
+Ranks(const std::vector<std::string>& names)
+{
+  std::vector<uint32_t> order(names.size());
+  for (uint32_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return NaturalLess(names[a], names[b]); });
+  std::vector<uint32_t> rank(names.size());
+  for (uint32_t i = 0; i < order.size(); i++) {
+    rank[order[i]] = i;
+  }
+  return rank;
+}
+
+/**
+ * \brief Whether a column is summed per bin, hasRaw telling that its file has a *Raw
+ * column, so that its Packets and Kilobytes are rates
+ */
+bool
+IsCountColumn(const std::string& column, bool hasRaw, const std::set<std::string>& sum,
+              const std::set<std::string>& mean)
+{
+  if (sum.count(column) > 0 || mean.count(column) > 0) {
+    return sum.count(column) > 0;
+  }
+  if (hasRaw && (column == "Packets" || column == "Kilobytes")) {
+    return false;
+  }
+  static const std::set<std::string> counts = { "Packets", "Kilobytes", "PacketRaw", "PacketsRaw", "KilobytesRaw",
+                                                "Packet", "Count", "Interests", "Retx", "Timeouts", "Nacks",
+                                                "NoRoute", "Rejected", "Nacked", "LinkDrop", "PitExpiry", "Loop" };
+  return counts.count(column) > 0;
+}
+
+bool
+ReadSchema(Input& input, const std::set<std::string>& sum, const std::set<std::string>& mean)
+{
+  const char* eol = static_cast<const char*>(std::memchr(input.data, '\n', input.size));
+  std::size_t length = eol != nullptr ? eol - input.data : input.size;
+  input.body = eol != nullptr ? length + 1 : input.size;
+
+  std::stringstream header(std::string(input.data, length));
+  std::string column;
+  Schema& schema = input.schema;
+  while (std::getline(header, column, '\t')) {
+    if (!column.empty() && column.back() == '\r') {
+      column.pop_back();
+    }
+    int c = static_cast<int>(schema.columns.size());
+    bool metric = false;
+    if (column == "Time") {
+      schema.time = c;
+    }
+    else if (column == "Node") {
+      schema.node = c;
+    }
+    else if (column == "FaceId" || column == "Face" || column == "Interface") {
+      schema.face = c;
+      schema.interface = column == "Interface";
+    }
+    else if (column == "Type") {
+      schema.type = c;
+    }
+    else if (column == "Prefix") {
+      schema.prefix = c;
+    }
+    else if (column != "AppId" && column != "SeqNo") {
+      metric = true;
+    }
+    schema.columns.push_back(column);
+    schema.metric.push_back(metric);
+  }
+
+  bool hasRaw = std::any_of(schema.columns.begin(), schema.columns.end(), [](const std::string& c) {
+    return c.size() > 3 && c.compare(c.size() - 3, 3, "Raw") == 0;
+  });
+  for (const std::string& c : schema.columns) {
+    schema.count.push_back(IsCountColumn(c, hasRaw, sum, mean));
+  }
+  return schema.node >= 0 || schema.prefix >= 0;
+}
+
+bool
+Map(Input& input)
+{
+  int fd = open(input.path.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    std::fprintf(stderr, "%s cannot be opened (%s)\n", input.path.c_str(), std::strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return false;
+  }
+  input.size = st.st_size;
+  if (input.size == 0) {
+    close(fd);
+    return true;
+  }
+  void* addr = mmap(nullptr, input.size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    std::fprintf(stderr, "%s cannot be mapped (%s)\n", input.path.c_str(), std::strerror(errno));
+    return false;
+  }
+  madvise(addr, input.size, MADV_SEQUENTIAL);
+  input.data = static_cast<const char*>(addr);
+  return true;
+}
+
+std::vector<std::string>
+Split(const std::string& list)
+{
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+void
+WriteCell(std::ostream& os, const Acc& acc, bool count)
+{
+  os << "\t";
+  if (acc.count > 0) {
+    os << (count ? acc.sum : acc.sum / acc.count);
+  }
+}
+
+void
+WriteSummaryRow(std::ostream& os, const std::string& key, const std::string& metric, const Acc& acc, bool count)
+{
+  os << key << "\t" << metric << "\t" << acc.count << "\t";
+  if (count) {
+    os << acc.sum;
+  }
+  os << "\t" << (acc.count > 0 ? acc.sum / acc.count : 0) << "\t" << acc.max << "\n";
+}
+
+/**
+ * \brief Time Node Face <metric>... and Node Metric Records Total Mean Max
+ */
+void
+WriteNodes(const Merged& merged, const std::vector<bool>& count, const std::vector<uint32_t>& metricOrder,
+           const std::vector<uint32_t>& metricColumn, double period, const std::string& out)
+{
+  std::vector<uint32_t> nodeRank = Ranks(merged.nodes);
+  std::vector<uint32_t> faceRank = Ranks(merged.faces);
+  auto rank = [](const std::vector<uint32_t>& ranks, uint32_t id) { return id == NONE ? 0 : ranks[id] + 1; };
+
+  // (bin, node and face rank) of every timed cell
+  std::vector<std::tuple<int64_t, uint64_t, const std::pair<SeriesKey, Acc>*>> cells;
+  std::unordered_map<uint64_t, Acc> totals; // node << 32 | metric
+  std::unordered_set<uint32_t> used;        // metrics with a time
+  for (const auto& shard : merged.series) {
+    for (const auto& entry : shard) {
+      const SeriesKey& k = entry.first;
+      if (k.bin != NO_TIME) {
+        cells.emplace_back(k.bin, static_cast<uint64_t>(rank(nodeRank, k.node)) << 32 | rank(faceRank, k.face), &entry);
+        used.insert(k.metric);
+      }
+      totals[static_cast<uint64_t>(k.node) << 32 | k.metric].Merge(entry.second);
+    }
+  }
+  std::sort(cells.begin(), cells.end(), [](const auto& a, const auto& b) {
+    return std::get<0>(a) != std::get<0>(b) ? std::get<0>(a) < std::get<0>(b) : std::get<1>(a) < std::get<1>(b);
+  });
+
+  std::vector<uint32_t> columns; // metrics of metricOrder that have a time
+  std::vector<int> columnOf(merged.metrics.size(), -1);
+  for (uint32_t m : metricOrder) {
+    if (used.count(m) > 0) {
+      columnOf[m] = static_cast<int>(columns.size());
+      columns.push_back(m);
+    }
+  }
+
+  std::ofstream series(out + "-series.txt");
+  series << "Time" << "\t" << "Node" << "\t" << "Face";
+  for (uint32_t m : columns) {
+    series << "\t" << merged.metrics[m];
+  }
+  series << "\n";
+
+  std::vector<Acc> row(columns.size());
+  for (std::size_t i = 0; i < cells.size();) {
+    const SeriesKey& first = std::get<2>(cells[i])->first;
+    std::fill(row.begin(), row.end(), Acc());
+    for (; i < cells.size() && std::get<0>(cells[i]) == first.bin && std::get<2>(cells[i])->first.node == first.node
+           && std::get<2>(cells[i])->first.face == first.face;
+         i++) {
+      row[columnOf[std::get<2>(cells[i])->first.metric]] = std::get<2>(cells[i])->second;
+    }
+    series << first.bin * period << "\t" << (first.node == NONE ? "" : merged.nodes[first.node]) << "\t"
+           << (first.face == NONE ? "" : merged.faces[first.face]);
+    for (std::size_t c = 0; c < row.size(); c++) {
+      WriteCell(series, row[c], count[columns[c]]);
+    }
+    series << "\n";
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> keys;
+  for (const auto& total : totals) {
+    keys.emplace_back(static_cast<uint32_t>(total.first >> 32), static_cast<uint32_t>(total.first));
+  }
+  std::sort(keys.begin(), keys.end(), [&](const auto& a, const auto& b) {
+    if (a.first != b.first) {
+      return rank(nodeRank, a.first) < rank(nodeRank, b.first);
+    }
+    return metricColumn[a.second] < metricColumn[b.second];
+  });
+
+  std::ofstream summary(out + "-nodes.txt");
+  summary << "Node" << "\t" << "Metric" << "\t" << "Records" << "\t" << "Total" << "\t" << "Mean" << "\t" << "Max"
+          << "\n";
+  for (const auto& key : keys) {
+    WriteSummaryRow(summary, key.first == NONE ? "" : merged.nodes[key.first], merged.metrics[key.second],
+                    totals.at(static_cast<uint64_t>(key.first) << 32 | key.second), count[key.second]);
+  }
+}
+
+/**
+ * \brief Time Prefix <metric>... and Prefix Metric Records Total Mean Max
+ */
+void
+WritePrefixes(const Merged& merged, const std::vector<bool>& count, const std::vector<uint32_t>& metricOrder,
+              const std::vector<uint32_t>& metricColumn, double period, const std::string& out)
+{
+  std::vector<uint32_t> prefixRank = Ranks(merged.prefixes);
+
+  std::vector<const std::pair<PrefixKey, Acc>*> cells;
+  std::unordered_map<uint64_t, Acc> totals; // prefix << 32 | metric
+  std::unordered_set<uint32_t> used;        // metrics with a prefix and a time
+  for (const auto& shard : merged.prefixSeries) {
+    for (const auto& entry : shard) {
+      if (entry.first.bin != NO_TIME) {
+        cells.push_back(&entry);
+        used.insert(entry.first.metric);
+      }
+      totals[static_cast<uint64_t>(entry.first.prefix) << 32 | entry.first.metric].Merge(entry.second);
+    }
+  }
+  std::sort(cells.begin(), cells.end(), [&](const auto* a, const auto* b) {
+    if (a->first.bin != b->first.bin) {
+      return a->first.bin < b->first.bin;
+    }
+    return prefixRank[a->first.prefix] < prefixRank[b->first.prefix];
+  });
+
+  std::vector<uint32_t> columns; // metrics of metricOrder that have a prefix
+  std::vector<int> columnOf(merged.metrics.size(), -1);
+  for (uint32_t m : metricOrder) {
+    if (used.count(m) > 0) {
+      columnOf[m] = static_cast<int>(columns.size());
+      columns.push_back(m);
+    }
+  }
+
+  std::ofstream series(out + "-prefix-series.txt");
+  series << "Time" << "\t" << "Prefix";
+  for (uint32_t m : columns) {
+    series << "\t" << merged.metrics[m];
+  }
+  series << "\n";
+
+  std::vector<Acc> row(columns.size());
+  for (std::size_t i = 0; i < cells.size();) {
+    const PrefixKey& first = cells[i]->first;
+    std::fill(row.begin(), row.end(), Acc());
+    for (; i < cells.size() && cells[i]->first.bin == first.bin && cells[i]->first.prefix == first.prefix; i++) {
+      row[columnOf[cells[i]->first.metric]] = cells[i]->second;
+    }
+    series << first.bin * period << "\t" << merged.prefixes[first.prefix];
+    for (std::size_t c = 0; c < row.size(); c++) {
+      WriteCell(series, row[c], count[columns[c]]);
+    }
+    series << "\n";
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> keys;
+  for (const auto& total : totals) {
+    keys.emplace_back(static_cast<uint32_t>(total.first >> 32), static_cast<uint32_t>(total.first));
+  }
+  std::sort(keys.begin(), keys.end(), [&](const auto& a, const auto& b) {
+    if (a.first != b.first) {
+      return prefixRank[a.first] < prefixRank[b.first];
+    }
+    return metricColumn[a.second] < metricColumn[b.second];
+  });
+
+  std::ofstream summary(out + "-prefixes.txt");
+  summary << "Prefix" << "\t" << "Metric" << "\t" << "Records" << "\t" << "Total" << "\t" << "Mean" << "\t" << "Max"
+          << "\n";
+  for (const auto& key : keys) {
+    WriteSummaryRow(summary, merged.prefixes[key.first], merged.metrics[key.second],
+                    totals.at(static_cast<uint64_t>(key.first) << 32 | key.second), count[key.second]);
+  }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  double period = 1.0;
+  std::string out = "trace-merge";
+  std::set<std::string> sum, mean;
+  std::vector<Input> inputs;
+  bool usage = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.compare(0, 10, "--threads=") == 0) {
+      threads = std::max(1l, std::atol(arg.c_str() + 10));
+    }
+    else if (arg.compare(0, 9, "--period=") == 0) {
+      period = std::atof(arg.c_str() + 9);
+    }
+    else if (arg.compare(0, 6, "--out=") == 0) {
+      out = arg.substr(6);
+    }
+    else if (arg.compare(0, 6, "--sum=") == 0) {
+      for (const std::string& column : Split(arg.substr(6))) {
+        sum.insert(column);
+      }
+    }
+    else if (arg.compare(0, 7, "--mean=") == 0) {
+      for (const std::string& column : Split(arg.substr(7))) {
+        mean.insert(column);
+      }
+    }
+    else if (arg.compare(0, 2, "--") != 0) {
+      Input input;
+      std::size_t equal = arg.find('=');
+      input.path = equal != std::string::npos ? arg.substr(equal + 1) : arg;
+      if (equal != std::string::npos) {
+        input.label = arg.substr(0, equal);
+      }
+      else {
+        std::size_t slash = input.path.find_last_of('/');
+        input.label = input.path.substr(slash == std::string::npos ? 0 : slash + 1);
+        input.label = input.label.substr(0, input.label.find_last_of('.'));
+      }
+      inputs.push_back(input);
+    }
+    else {
+      usage = true;
+    }
+  }
+  if (usage || inputs.empty() || !(period > 0)) {
+    std::fprintf(stderr,
+                 "usage: %s [--threads=N] [--period=S] [--out=PREFIX] [--sum=Col,...] [--mean=Col,...] "
+                 "[label=]<trace> ...\n",
+                 argv[0]);
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<Chunk> chunks;
+  std::size_t totalBytes = 0;
+  for (uint32_t i = 0; i < inputs.size(); i++) {
+    Input& input = inputs[i];
+    if (!Map(input)) {
+      return 1;
+    }
+    if (input.size == 0) {
+      continue;
+    }
+    if (!ReadSchema(input, sum, mean)) {
+      std::fprintf(stderr, "%s has no Node or Prefix column, skipped\n", input.path.c_str());
+      continue;
+    }
+    totalBytes += input.size;
+
+    for (std::size_t begin = input.body; begin < input.size;) {
+      std::size_t end = std::min(begin + CHUNK, input.size);
+      if (end < input.size) {
+        const char* eol = static_cast<const char*>(std::memchr(input.data + end, '\n', input.size - end));
+        end = eol != nullptr ? eol - input.data + 1 : input.size;
+      }
+      chunks.push_back(Chunk{ i, begin, end });
+      begin = end;
+    }
+  }
+
+  threads = std::min<std::size_t>(threads, std::max<std::size_t>(1, chunks.size()));
+  std::vector<Partial> partials(threads, Partial(threads));
+  std::atomic<std::size_t> next(0);
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      for (std::size_t c = next++; c < chunks.size(); c = next++) {
+        const Chunk& chunk = chunks[c];
+        const Input& input = inputs[chunk.input];
+        partials[t].Parse(chunk.input, input, input.data + chunk.begin, input.data + chunk.end, period);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  Merged merged;
+  merged.Merge(partials, inputs, threads);
+  partials.clear();
+
+  // metrics are written in natural order of their names: column of a metric and metric of a column
+  std::vector<uint32_t> metricColumn = Ranks(merged.metrics);
+  std::vector<uint32_t> metricOrder(metricColumn.size());
+  for (uint32_t m = 0; m < metricColumn.size(); m++) {
+    metricOrder[metricColumn[m]] = m;
+  }
+  WriteNodes(merged, merged.counts, metricOrder, metricColumn, period, out);
+  WritePrefixes(merged, merged.counts, metricOrder, metricColumn, period, out);
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::fprintf(stderr, "%zu bytes in %zu chunks, %u threads, %.3f s (%.1f MB/s); %zu metrics, %zu nodes, %zu prefixes\n",
+               totalBytes, chunks.size(), threads, seconds, seconds > 0 ? totalBytes / seconds / 1e6 : 0.0,
+               merged.metrics.size(), merged.nodes.size(), merged.prefixes.size());
+
+  for (const Input& input : inputs) {
+    if (input.data != nullptr) {
+      munmap(const_cast<char*>(input.data), input.size);
+    }
+  }
+  return 0;
+}